@@ -8,85 +8,674 @@
 
 #include "BaseShader.hpp"
 
-// Constructor reads and builds the shader from the vertex and fragment paths
-BaseShader::BaseShader(const char* vertexPath, const char* fragmentPath) {
-	
+#include <cstring>
+
+bool BaseShader::parallelCompile = false;
+UniformCallStats BaseShader::frameStats = { 0, 0 };
+
+// Constructor reads and builds the shader from the vertex and fragment paths, using the binary cache if given
+BaseShader::BaseShader(const char* vertexPath, const char* fragmentPath, ProgramBinaryCache* cache, BuildMode mode)
+	: vertexPath(vertexPath), fragmentPath(fragmentPath), building(false), pendingVertex(0), pendingFragment(0),
+	cache(cache), cacheKey(0), failed(false), reloading(false) {
+	reload.program = 0;
+	build(mode, NULL, NULL);
+}
+
+// Constructor for a variant with defines injected after the #version line of each stage
+BaseShader::BaseShader(const char* vertexPath, const char* fragmentPath, const ShaderDefines &defines,
+	ProgramBinaryCache* cache, BuildMode mode)
+	: vertexPath(vertexPath), fragmentPath(fragmentPath), defines(defines), building(false), pendingVertex(0), pendingFragment(0),
+	cache(cache), cacheKey(0), failed(false), reloading(false) {
+	reload.program = 0;
+	build(mode, NULL, NULL);
+}
+
+// Constructor for sources that were already preprocessed, for example by preprocessShaderBatch
+BaseShader::BaseShader(const char* vertexPath, const char* fragmentPath, const ShaderDefines &defines,
+	const ShaderSource &vertexSource, const ShaderSource &fragmentSource, ProgramBinaryCache* cache, BuildMode mode)
+	: vertexPath(vertexPath), fragmentPath(fragmentPath), defines(defines), building(false), pendingVertex(0), pendingFragment(0),
+	cache(cache), cacheKey(0), failed(false), reloading(false) {
+	reload.program = 0;
+	build(mode, &vertexSource, &fragmentSource);
+}
+
+// Helper function to read the sources unless they were given, and start the build
+void BaseShader::build(BuildMode mode, const ShaderSource* vertexSource, const ShaderSource* fragmentSource) {
+
 	/* ----- Retrieve the vertex/fragment source code from the paths ----- */
 
-	std::string vertexCode, fragmentCode;
-	std::ifstream vShaderFile, fShaderFile;
-
-	// Ensure the ifstream objects can throw exceptions
-	vShaderFile.exceptions(std::ifstream::failbit || std::ifstream::badbit);
-	fShaderFile.exceptions(std::ifstream::failbit || std::ifstream::badbit);
-
-	// Try to open and read the files
-	try {
-		// Open the files
-		vShaderFile.open(vertexPath);
-		fShaderFile.open(fragmentPath);
-		std::stringstream vShaderStream, fShaderStream;
-		// Read the file's buffer contents into the streams
-		vShaderStream << vShaderFile.rdbuf();
-		fShaderStream << fShaderFile.rdbuf();
-		// Close the file handlers
-		vShaderFile.close();
-		fShaderFile.close();
-		vertexCode = vShaderStream.str();
-		fragmentCode = fShaderStream.str();
-	}
-	catch (std::ifstream::failure& e) {
-		std::cout << "Error: shader file unsuccessfully found" << std::endl;
-	}
-	const char* vShaderCode = vertexCode.c_str();
-	const char* fShaderCode = fragmentCode.c_str();
-
-	/* ----- Compile the shaders ----- */
-
-	unsigned int vertex, fragment;
-	// Vertex shader
-	vertex = glCreateShader(GL_VERTEX_SHADER);
-	glShaderSource(vertex, 1, &vShaderCode, NULL);
-	glCompileShader(vertex);
-	checkCompileErrors(vertex, "VERTEX");
-	// Fragment shader
-	fragment = glCreateShader(GL_FRAGMENT_SHADER);
-	glShaderSource(fragment, 1, &fShaderCode, NULL);
-	glCompileShader(fragment);
-	checkCompileErrors(fragment, "FRAGMENT");
-	// Shader Program
+	// The program object always exists so that a hot reload can replace a failed build
 	ID = glCreateProgram();
-	glAttachShader(ID, vertex);
-	glAttachShader(ID, fragment);
-	glLinkProgram(ID);
-	checkCompileErrors(ID, "PROGRAM");
+	ShaderSource vertexCode, fragmentCode;
+	if (vertexSource != NULL && fragmentSource != NULL) {
+		vertexCode = *vertexSource;
+		fragmentCode = *fragmentSource;
+	}
+	else if (!loadSources(vertexCode, fragmentCode)) {
+		std::cout << "Error: could not load the sources for " << vertexPath << " + " << fragmentPath << std::endl;
+		failed = true;
+	}
+	sourceFiles = vertexCode.getPaths();
+	sourceFiles.insert(sourceFiles.end(), fragmentCode.getPaths().begin(), fragmentCode.getPaths().end());
+	timing = ProgramTiming();
+	timing.vertexPath = vertexPath;
+	timing.fragmentPath = fragmentPath;
+	timing.defines = defines.toString();
+	if (failed) {
+		ShaderBuildLog::record(timing);
+		return;
+	}
+	timing.vertex.sourceHash = vertexCode.hash();
+	timing.fragment.sourceHash = fragmentCode.hash();
+	buildStart = std::chrono::high_resolution_clock::now();
+
+	/* ----- Load a previously linked binary if the sources are unchanged ----- */
+
+	if (cache != NULL && cache->isEnabled()) {
+		std::vector<unsigned long long> sources;
+		sources.push_back(timing.vertex.sourceHash);
+		sources.push_back(timing.fragment.sourceHash);
+		cacheKey = cache->makeKey(sources, timing.defines);
+		timing.cacheKey = cacheKey;
+		if (cache->load(ID, cacheKey)) {
+			timing.cacheHit = true;
+			timing.cacheLoadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - buildStart).count();
+			timing.totalMilliseconds = timing.cacheLoadMilliseconds;
+			timing.success = true;
+			ShaderBuildLog::record(timing);
+			buildUniformTable();
+			return;
+		}
+		// A rejected binary can leave the program in a failed state, so start from a fresh one
+		glDeleteProgram(ID);
+		ID = glCreateProgram();
+		glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+
+	/* ----- Submit the compile and link without querying their status ----- */
+
+	submitProgram(ID, vertexCode, fragmentCode, pendingVertex, pendingFragment, timing);
+	building = true;
+
+	if (mode == BUILD_BLOCKING) {
+		finishBuild();
+	}
+}
+
+// Destructor deletes the program and anything still being built
+BaseShader::~BaseShader() {
+	if (building) {
+		glDeleteShader(pendingVertex);
+		glDeleteShader(pendingFragment);
+	}
+	if (reloading) {
+		discardReload();
+	}
+	glDeleteProgram(ID);
+}
+
+// Let the driver compile on background threads if GL_KHR_parallel_shader_compile is available
+bool BaseShader::enableParallelCompile() {
+	// Passing the maximum value asks for as many threads as the implementation allows
+	if (GLEW_KHR_parallel_shader_compile) {
+		glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+		parallelCompile = true;
+	}
+	else if (GLEW_ARB_parallel_shader_compile) {
+		glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+		parallelCompile = true;
+	}
+	return parallelCompile;
+}
+
+// Poll an async build without blocking, finishing it once the driver reports completion
+bool BaseShader::isReady() {
+	if (!building) {
+		return !failed;
+	}
+	// Without the extension any status query blocks, so the build is finished on the first poll
+	if (parallelCompile) {
+		int complete = 0;
+		glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &complete);
+		if (!complete) {
+			return false;
+		}
+	}
+	finishBuild();
+	return !failed;
+}
+
+// True if the sources could not be loaded or the last build did not compile and link
+bool BaseShader::hasFailed() const {
+	return failed;
+}
+
+// Block until the build is complete, then check for errors and list the uniforms
+void BaseShader::finishBuild() {
+	if (!building) {
+		return;
+	}
+	failed = !checkBuild(pendingVertex, pendingFragment, ID, timing);
+	timing.totalMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - buildStart).count();
+	ShaderBuildLog::record(timing);
+	buildUniformTable();
+	if (cache != NULL) {
+		cache->store(ID, cacheKey, timing.totalMilliseconds);
+	}
 	// Delete the unnecessary shaders
-	glDeleteShader(vertex);
-	glDeleteShader(fragment);
+	glDetachShader(ID, pendingVertex);
+	glDetachShader(ID, pendingFragment);
+	glDeleteShader(pendingVertex);
+	glDeleteShader(pendingFragment);
+	building = false;
+}
+
+// True while the build started by the constructor is unfinished
+bool BaseShader::isBuilding() const {
+	return building;
+}
+
+// Preprocess both stages from disk with this shader's defines, safe to call from any thread
+bool BaseShader::loadSources(ShaderSource &vertexCode, ShaderSource &fragmentCode) const {
+	return preprocessShader(vertexPath, defines, vertexCode) && preprocessShader(fragmentPath, defines, fragmentCode);
+}
+
+// Compile, link and status query times of the last build or reload that finished
+const ProgramTiming &BaseShader::getBuildTiming() const {
+	return timing;
+}
+
+// Vertex and fragment source paths the shader was built from
+const std::string &BaseShader::getVertexPath() const {
+	return vertexPath;
+}
+
+const std::string &BaseShader::getFragmentPath() const {
+	return fragmentPath;
+}
+
+// Every file read to build the shader, including the ones pulled in by #include
+const std::vector<std::string> &BaseShader::getSourceFiles() const {
+	return sourceFiles;
+}
+
+// Replace the source files with the ones read for the last reload swapped in by pollReload. Another thread
+// may be reading getSourceFiles, so the caller must hold whatever lock guards those reads
+void BaseShader::updateSourceFiles() {
+	if (!reloadedFiles.empty()) {
+		sourceFiles.swap(reloadedFiles);
+		reloadedFiles.clear();
+	}
+}
+
+// Start an async build of new sources into a separate program, replacing any reload in progress
+void BaseShader::beginReload(const ShaderSource &vertexCode, const ShaderSource &fragmentCode) {
+	if (reloading) {
+		discardReload();
+	}
+	submitReload(reload, vertexCode, fragmentCode);
+	reloading = true;
+}
+
+// Compile and link new sources into a separate program and wait for the result, on a thread whose context
+// shares objects with the render thread's. The result is given to adoptReload on the render thread
+ReloadBuild BaseShader::buildReload(const ShaderSource &vertexCode, const ShaderSource &fragmentCode) const {
+	ReloadBuild build;
+	submitReload(build, vertexCode, fragmentCode);
+	// Blocking is fine on this thread, only the render thread must not wait on the driver
+	checkBuild(build.vertex, build.fragment, build.program, build.timing);
+	build.timing.totalMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - build.start).count();
+	build.checked = true;
+	// The link is only known to be complete in this context until the commands have finished
+	glFinish();
+	return build;
+}
+
+// Take over a reload made by buildReload, replacing any reload in progress. The next pollReload swaps it in
+void BaseShader::adoptReload(const ReloadBuild &build) {
+	if (reloading) {
+		discardReload();
+	}
+	reload = build;
+	reloading = true;
+}
+
+// Delete a reload made by buildReload that will not be adopted
+void BaseShader::deleteReload(const ReloadBuild &build) {
+	glDeleteShader(build.vertex);
+	glDeleteShader(build.fragment);
+	glDeleteProgram(build.program);
+}
+
+// Poll a reload, swapping in the new program if it linked, true if a swap happened. Only a reload from
+// buildReload or one polled with parallel compile available is checked without blocking. Reloads wait
+// until the first build has finished
+bool BaseShader::pollReload() {
+	// The first build's stages are still attached to the program a swap would delete
+	if (!reloading || building) {
+		return false;
+	}
+	if (!reload.checked) {
+		if (parallelCompile) {
+			int complete = 0;
+			glGetProgramiv(reload.program, GL_COMPLETION_STATUS_KHR, &complete);
+			if (!complete) {
+				return false;
+			}
+		}
+		checkBuild(reload.vertex, reload.fragment, reload.program, reload.timing);
+		reload.timing.totalMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - reload.start).count();
+		reload.checked = true;
+	}
+
+	// A failed build keeps the current program running
+	ShaderBuildLog::record(reload.timing);
+	if (!reload.timing.success) {
+		std::cout << "Error: reload of " << fragmentPath << " failed, keeping the previous program" << std::endl;
+		discardReload();
+		return false;
+	}
+	timing = reload.timing;
+	if (cache != NULL) {
+		cache->store(reload.program, reload.cacheKey, reload.timing.totalMilliseconds);
+	}
+
+	// Remember where each uniform lived in the old program before the table is rebuilt
+	unsigned int oldProgram = ID;
+	std::vector<int> oldLocations(uniforms.size());
+	for (size_t i = 0; i < uniforms.size(); i++) {
+		oldLocations[i] = uniforms[i].location;
+	}
+	ID = reload.program;
+	buildUniformTable();
+
+	// Carry the uniform values over to the new program
+	unsigned int previousProgram = GLState::currentProgram();
+	GLState::useProgram(ID);
+	for (size_t i = 0; i < oldLocations.size(); i++) {
+		const UniformInfo &info = uniforms[i];
+		if (oldLocations[i] == -1 || info.location == -1) {
+			// Nothing was carried over, so the next set must reach the program
+			info.hasValue = false;
+			continue;
+		}
+		copyUniformValue(oldProgram, oldLocations[i], info.location, info.type);
+		for (int element = 1; element < info.size; element++) {
+			std::string elementName = info.name + "[" + std::to_string(element) + "]";
+			int from = glGetUniformLocation(oldProgram, elementName.c_str());
+			int to = glGetUniformLocation(ID, elementName.c_str());
+			if (from != -1 && to != -1) {
+				copyUniformValue(oldProgram, from, to, info.type);
+			}
+		}
+	}
+	GLState::useProgram(previousProgram == oldProgram ? ID : previousProgram);
+	glDeleteProgram(oldProgram);
+
+	glDetachShader(ID, reload.vertex);
+	glDetachShader(ID, reload.fragment);
+	glDeleteShader(reload.vertex);
+	glDeleteShader(reload.fragment);
+	reload.program = 0;
+	reloadedFiles.swap(reload.sourceFiles);
+	reload.sourceFiles.clear();
+	reloading = false;
+	failed = false;
+	std::cout << "Reloaded shader " << vertexPath << " + " << fragmentPath << std::endl;
+	return true;
 }
 
 // Activate/Use the shader
 void BaseShader::use() {
-	glUseProgram(ID);
+	GLState::useProgram(ID);
 }
 
 // Utility function to set bool
 void BaseShader::setBool(const std::string &name, bool value) const {
-	glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+	set(UniformHandle<bool>(findUniformSlot(hashString(name.c_str(), name.size()), name.c_str(), name.size())), value);
 }
 
 // Utility function to set int
 void BaseShader::setInt(const std::string &name, int value) const {
-	glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+	set(UniformHandle<int>(findUniformSlot(hashString(name.c_str(), name.size()), name.c_str(), name.size())), value);
 }
 
 // Utility function to set float
 void BaseShader::setFloat(const std::string &name, float value) const {
-	glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+	set(UniformHandle<float>(findUniformSlot(hashString(name.c_str(), name.size()), name.c_str(), name.size())), value);
+}
+
+// Set a uniform through a resolved handle without any name lookup
+void BaseShader::set(UniformHandle<bool> uniform, bool value) const {
+	if (uniform.valid() && updateShadowValue(uniform.slot, (unsigned int)value)) {
+		glUniform1i(uniforms[uniform.slot].location, (int)value);
+	}
+}
+
+void BaseShader::set(UniformHandle<int> uniform, int value) const {
+	if (uniform.valid() && updateShadowValue(uniform.slot, (unsigned int)value)) {
+		glUniform1i(uniforms[uniform.slot].location, value);
+	}
+}
+
+void BaseShader::set(UniformHandle<float> uniform, float value) const {
+	unsigned int bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	if (uniform.valid() && updateShadowValue(uniform.slot, bits)) {
+		glUniform1f(uniforms[uniform.slot].location, value);
+	}
+}
+
+// Look up a uniform block found at link time, NULL if it is not active
+const UniformBlockInfo* BaseShader::getUniformBlock(const std::string &name) const {
+	for (size_t i = 0; i < uniformBlocks.size(); i++) {
+		if (uniformBlocks[i].name == name) {
+			return &uniformBlocks[i];
+		}
+	}
+	return NULL;
+}
+
+// Attach a uniform block to a buffer binding point, kept across hot reloads
+void BaseShader::bindUniformBlock(const std::string &name, unsigned int binding) {
+	for (size_t i = 0; i < uniformBlocks.size(); i++) {
+		if (uniformBlocks[i].name == name) {
+			glUniformBlockBinding(ID, uniformBlocks[i].index, binding);
+			uniformBlocks[i].binding = (int)binding;
+			return;
+		}
+	}
+	std::cout << "Error: uniform block " << name << " is not active" << std::endl;
+}
+
+// Forget the last values sent, needed after uniforms are set with raw glUniform calls
+void BaseShader::invalidateShadowValues() {
+	for (size_t i = 0; i < uniforms.size(); i++) {
+		uniforms[i].hasValue = false;
+	}
+}
+
+// Uniform calls issued and skipped by all shaders since the last reset, reset once per frame
+UniformCallStats BaseShader::getFrameStats() {
+	return frameStats;
+}
+
+void BaseShader::resetFrameStats() {
+	frameStats.issued = 0;
+	frameStats.skipped = 0;
+}
+
+// Helper function to record the value about to be sent, false if the program already holds it
+bool BaseShader::updateShadowValue(int slot, unsigned int bits) const {
+	const UniformInfo &info = uniforms[slot];
+	// Inactive uniforms have nothing to update and keep no value
+	if (info.location == -1) {
+		return false;
+	}
+	if (info.hasValue && info.shadowValue == bits) {
+		frameStats.skipped++;
+		return false;
+	}
+	info.hasValue = true;
+	info.shadowValue = bits;
+	frameStats.issued++;
+	return true;
+}
+
+// Look up a uniform location in the table built at link time, -1 if it is not active
+int BaseShader::getUniformLocation(const std::string &name) const {
+	int slot = findUniformSlot(hashString(name.c_str(), name.size()), name.c_str(), name.size());
+	return slot == -1 ? -1 : uniforms[slot].location;
+}
+
+// Helper function to find the table index of a uniform by name hash, -1 if it is not active. Array names are
+// accepted with or without "[0]"
+int BaseShader::findUniformSlot(unsigned int hash, const char* name, size_t length) const {
+	if (uniformSlots.empty()) {
+		return -1;
+	}
+	// The table holds arrays under the plain name, so "name[0]" is looked up as "name"
+	if (length > 3 && std::memcmp(name + length - 3, "[0]", 3) == 0) {
+		length -= 3;
+		hash = hashString(name, length);
+	}
+	size_t mask = uniformSlots.size() - 1;
+	// Linear probe until the name is found or an empty slot ends the chain
+	for (size_t slot = hash & mask; uniformSlots[slot] != -1; slot = (slot + 1) & mask) {
+		const UniformInfo &info = uniforms[uniformSlots[slot]];
+		if (info.hash == hash && info.name.size() == length && std::memcmp(info.name.data(), name, length) == 0) {
+			return uniformSlots[slot];
+		}
+	}
+	return -1;
+}
+
+// Helper function to create, compile and link the stages into the program without querying their status
+void BaseShader::submitProgram(unsigned int program, const ShaderSource &vertexCode, const ShaderSource &fragmentCode,
+	unsigned int &vertex, unsigned int &fragment, ProgramTiming &timing) {
+	typedef std::chrono::high_resolution_clock Clock;
+	// The segments point into the mapped files, and the driver copies them during glShaderSource
+	// Vertex shader
+	vertex = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(vertex, vertexCode.count(), vertexCode.strings(), vertexCode.lengths());
+	Clock::time_point start = Clock::now();
+	glCompileShader(vertex);
+	timing.vertex.compileMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	// Fragment shader
+	fragment = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(fragment, fragmentCode.count(), fragmentCode.strings(), fragmentCode.lengths());
+	start = Clock::now();
+	glCompileShader(fragment);
+	timing.fragment.compileMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	// Shader Program
+	glAttachShader(program, vertex);
+	glAttachShader(program, fragment);
+	start = Clock::now();
+	glLinkProgram(program);
+	timing.linkMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Helper function to check both stages and the program, timing each status query
+bool BaseShader::checkBuild(unsigned int vertex, unsigned int fragment, unsigned int program, ProgramTiming &buildTiming) {
+	typedef std::chrono::high_resolution_clock Clock;
+	// Without parallel compile the driver usually defers the real work until the first status query
+	Clock::time_point start = Clock::now();
+	buildTiming.vertex.success = checkCompileErrors(vertex, "VERTEX");
+	buildTiming.vertex.statusMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	glGetShaderiv(vertex, GL_INFO_LOG_LENGTH, &buildTiming.vertex.infoLogLength);
+
+	start = Clock::now();
+	buildTiming.fragment.success = checkCompileErrors(fragment, "FRAGMENT");
+	buildTiming.fragment.statusMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	glGetShaderiv(fragment, GL_INFO_LOG_LENGTH, &buildTiming.fragment.infoLogLength);
+
+	start = Clock::now();
+	bool linked = checkCompileErrors(program, "PROGRAM");
+	buildTiming.statusMilliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	glGetProgramiv(program, GL_INFO_LOG_LENGTH, &buildTiming.infoLogLength);
+
+	buildTiming.success = buildTiming.vertex.success && buildTiming.fragment.success && linked;
+	return buildTiming.success;
+}
+
+// Helper function to create a reload program and submit the new sources to it without querying their status
+void BaseShader::submitReload(ReloadBuild &build, const ShaderSource &vertexCode, const ShaderSource &fragmentCode) const {
+	build.program = glCreateProgram();
+	build.cacheKey = 0;
+	build.checked = false;
+	build.timing = ProgramTiming();
+	build.timing.vertexPath = vertexPath;
+	build.timing.fragmentPath = fragmentPath;
+	build.timing.defines = defines.toString();
+	build.timing.reload = true;
+	build.timing.vertex.sourceHash = vertexCode.hash();
+	build.timing.fragment.sourceHash = fragmentCode.hash();
+	build.sourceFiles = vertexCode.getPaths();
+	build.sourceFiles.insert(build.sourceFiles.end(), fragmentCode.getPaths().begin(), fragmentCode.getPaths().end());
+	if (cache != NULL && cache->isEnabled()) {
+		std::vector<unsigned long long> sources;
+		sources.push_back(build.timing.vertex.sourceHash);
+		sources.push_back(build.timing.fragment.sourceHash);
+		build.cacheKey = cache->makeKey(sources, build.timing.defines);
+		build.timing.cacheKey = build.cacheKey;
+		glProgramParameteri(build.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+	build.start = std::chrono::high_resolution_clock::now();
+	submitProgram(build.program, vertexCode, fragmentCode, build.vertex, build.fragment, build.timing);
+}
+
+// Helper function to throw away an unfinished or failed reload
+void BaseShader::discardReload() {
+	deleteReload(reload);
+	reload.program = 0;
+	reloading = false;
+}
+
+// Helper function to copy one uniform value from a program into the currently bound program
+void BaseShader::copyUniformValue(unsigned int fromProgram, int fromLocation, int toLocation, GLenum type) {
+	float f[16];
+	int i[4];
+	unsigned int u[4];
+	switch (type) {
+	case GL_FLOAT:        glGetUniformfv(fromProgram, fromLocation, f); glUniform1fv(toLocation, 1, f); break;
+	case GL_FLOAT_VEC2:   glGetUniformfv(fromProgram, fromLocation, f); glUniform2fv(toLocation, 1, f); break;
+	case GL_FLOAT_VEC3:   glGetUniformfv(fromProgram, fromLocation, f); glUniform3fv(toLocation, 1, f); break;
+	case GL_FLOAT_VEC4:   glGetUniformfv(fromProgram, fromLocation, f); glUniform4fv(toLocation, 1, f); break;
+	case GL_FLOAT_MAT2:   glGetUniformfv(fromProgram, fromLocation, f); glUniformMatrix2fv(toLocation, 1, GL_FALSE, f); break;
+	case GL_FLOAT_MAT3:   glGetUniformfv(fromProgram, fromLocation, f); glUniformMatrix3fv(toLocation, 1, GL_FALSE, f); break;
+	case GL_FLOAT_MAT4:   glGetUniformfv(fromProgram, fromLocation, f); glUniformMatrix4fv(toLocation, 1, GL_FALSE, f); break;
+	case GL_UNSIGNED_INT: glGetUniformuiv(fromProgram, fromLocation, u); glUniform1uiv(toLocation, 1, u); break;
+	case GL_INT_VEC2:
+	case GL_BOOL_VEC2:    glGetUniformiv(fromProgram, fromLocation, i); glUniform2iv(toLocation, 1, i); break;
+	case GL_INT_VEC3:
+	case GL_BOOL_VEC3:    glGetUniformiv(fromProgram, fromLocation, i); glUniform3iv(toLocation, 1, i); break;
+	case GL_INT_VEC4:
+	case GL_BOOL_VEC4:    glGetUniformiv(fromProgram, fromLocation, i); glUniform4iv(toLocation, 1, i); break;
+	// Int, bool and all sampler types
+	default:              glGetUniformiv(fromProgram, fromLocation, i); glUniform1iv(toLocation, 1, i); break;
+	}
+}
+
+// Helper function to list the active uniforms of the linked program into the table
+void BaseShader::buildUniformTable() {
+	int count = 0, maxLength = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+	// Uniforms from a previous link keep their slots so resolved handles stay valid across reloads
+	for (size_t i = 0; i < uniforms.size(); i++) {
+		uniforms[i].location = -1;
+	}
+	std::vector<char> nameBuffer(maxLength + 1);
+	for (int i = 0; i < count; i++) {
+		UniformInfo info;
+		int length = 0;
+		glGetActiveUniform(ID, i, (GLsizei)nameBuffer.size(), &length, &info.size, &info.type, nameBuffer.data());
+		info.name.assign(nameBuffer.data(), length);
+		// Arrays are reported as "name[0]" and stored under the plain name, lookups accept either spelling
+		if (info.name.size() > 3 && info.name.compare(info.name.size() - 3, 3, "[0]") == 0) {
+			info.name.resize(info.name.size() - 3);
+		}
+		// Uniforms inside uniform blocks have no location and are skipped
+		info.location = glGetUniformLocation(ID, nameBuffer.data());
+		if (info.location == -1) {
+			continue;
+		}
+		info.hash = hashString(info.name.c_str(), info.name.size());
+		info.hasValue = false;
+		info.shadowValue = 0;
+		int existing = findUniformSlot(info.hash, info.name.c_str(), info.name.size());
+		if (existing != -1) {
+			// Values copied over on reload are still known, so the shadow copy is kept
+			info.hasValue = uniforms[existing].hasValue;
+			info.shadowValue = uniforms[existing].shadowValue;
+			uniforms[existing] = info;
+		}
+		else {
+			uniforms.push_back(info);
+		}
+	}
+
+	// Size the table to a power of two at most half full so probe chains stay short
+	size_t capacity = 8;
+	while (capacity < uniforms.size() * 2) {
+		capacity *= 2;
+	}
+	uniformSlots.assign(capacity, -1);
+	for (size_t i = 0; i < uniforms.size(); i++) {
+		size_t slot = uniforms[i].hash & (capacity - 1);
+		while (uniformSlots[slot] != -1) {
+			slot = (slot + 1) & (capacity - 1);
+		}
+		uniformSlots[slot] = (int)i;
+	}
+
+	// Uniforms inside blocks were skipped above and are listed with their blocks instead
+	buildUniformBlockTable();
+}
+
+// Helper function to list the active uniform blocks and their members, restoring earlier bindings
+void BaseShader::buildUniformBlockTable() {
+	std::vector<UniformBlockInfo> previous;
+	previous.swap(uniformBlocks);
+
+	int blockCount = 0, maxNameLength = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxNameLength);
+	std::vector<char> nameBuffer(maxNameLength + 1);
+
+	for (int b = 0; b < blockCount; b++) {
+		UniformBlockInfo block;
+		int length = 0, memberCount = 0;
+		glGetActiveUniformBlockName(ID, b, (GLsizei)nameBuffer.size(), &length, nameBuffer.data());
+		block.name.assign(nameBuffer.data(), length);
+		block.index = (unsigned int)b;
+		glGetActiveUniformBlockiv(ID, b, GL_UNIFORM_BLOCK_DATA_SIZE, &block.dataSize);
+		glGetActiveUniformBlockiv(ID, b, GL_UNIFORM_BLOCK_BINDING, &block.binding);
+		glGetActiveUniformBlockiv(ID, b, GL_UNIFORM_BLOCK_ACTIVE_UNIFORMS, &memberCount);
+
+		// Query the layout of every member in one call per property
+		std::vector<int> indices(memberCount);
+		if (memberCount > 0) {
+			glGetActiveUniformBlockiv(ID, b, GL_UNIFORM_BLOCK_ACTIVE_UNIFORM_INDICES, indices.data());
+		}
+		std::vector<GLuint> memberIndices(indices.begin(), indices.end());
+		std::vector<int> types(memberCount), sizes(memberCount), offsets(memberCount), arrayStrides(memberCount), matrixStrides(memberCount);
+		if (memberCount > 0) {
+			glGetActiveUniformsiv(ID, memberCount, memberIndices.data(), GL_UNIFORM_TYPE, types.data());
+			glGetActiveUniformsiv(ID, memberCount, memberIndices.data(), GL_UNIFORM_SIZE, sizes.data());
+			glGetActiveUniformsiv(ID, memberCount, memberIndices.data(), GL_UNIFORM_OFFSET, offsets.data());
+			glGetActiveUniformsiv(ID, memberCount, memberIndices.data(), GL_UNIFORM_ARRAY_STRIDE, arrayStrides.data());
+			glGetActiveUniformsiv(ID, memberCount, memberIndices.data(), GL_UNIFORM_MATRIX_STRIDE, matrixStrides.data());
+		}
+		int maxMemberLength = 0;
+		glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxMemberLength);
+		std::vector<char> memberName(maxMemberLength + 1);
+		for (int m = 0; m < memberCount; m++) {
+			UniformBlockMember member;
+			glGetActiveUniformName(ID, memberIndices[m], (GLsizei)memberName.size(), &length, memberName.data());
+			member.name.assign(memberName.data(), length);
+			member.type = (GLenum)types[m];
+			member.size = sizes[m];
+			member.offset = offsets[m];
+			member.arrayStride = arrayStrides[m];
+			member.matrixStride = matrixStrides[m];
+			block.members.push_back(member);
+		}
+
+		// Block bindings are reset by a relink, so put back the ones chosen for the previous program
+		for (size_t i = 0; i < previous.size(); i++) {
+			if (previous[i].name == block.name && previous[i].binding != block.binding) {
+				glUniformBlockBinding(ID, block.index, previous[i].binding);
+				block.binding = previous[i].binding;
+			}
+		}
+		uniformBlocks.push_back(block);
+	}
 }
 
 // Helper function to check compile and linking status
-void::BaseShader::checkCompileErrors(unsigned int shader, std::string type) {
+bool BaseShader::checkCompileErrors(unsigned int shader, std::string type) {
 	int success;
 	char infoLog[1024];
 	if (type != "PROGRAM") {
@@ -103,4 +692,5 @@ void::BaseShader::checkCompileErrors(unsigned int shader, std::string type) {
 			std::cout << "Error: program linking error\n" << infoLog << std::endl;
 		}
 	}
+	return success != 0;
 }
\ No newline at end of file
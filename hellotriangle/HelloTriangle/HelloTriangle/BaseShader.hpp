@@ -12,16 +12,124 @@
 #include <GL/glew.h>
 
 #include <string>
-#include <fstream>
-#include <sstream>
+#include <chrono>
+#include <vector>
 #include <iostream>
 
+#include "UniformHandle.hpp"
+#include "ShaderCache.hpp"
+#include "ShaderPreprocessor.hpp"
+#include "GLState.hpp"
+#include "ShaderTimings.hpp"
+
+// Number of glUniform calls issued and skipped because the program already held the value
+struct UniformCallStats {
+	unsigned int issued;
+	unsigned int skipped;
+};
+
+// Member of a uniform block with the offsets and strides the driver chose for it
+struct UniformBlockMember {
+	std::string name;
+	GLenum type;
+	int size;
+	int offset;
+	int arrayStride;
+	int matrixStride;
+};
+
+// Active uniform block reported by the program after linking
+struct UniformBlockInfo {
+	std::string name;
+	unsigned int index;
+	int dataSize;
+	int binding;
+	std::vector<UniformBlockMember> members;
+};
+
+// Replacement program built by a hot reload, its stages attached until it is swapped in
+struct ReloadBuild {
+	unsigned int program, vertex, fragment;
+	unsigned long long cacheKey;
+	std::chrono::high_resolution_clock::time_point start;
+	ProgramTiming timing;
+	// Set once the build has been waited on, so swapping it in does not query the driver again
+	bool checked;
+	// Every file read for the new sources, including #include files
+	std::vector<std::string> sourceFiles;
+};
+
 class BaseShader {
 public:
+	// Blocking builds check for errors immediately, async builds are finished once the driver is done
+	enum BuildMode { BUILD_BLOCKING, BUILD_ASYNC };
+
 	unsigned int ID;
 
-	// Constructor reads and builds the shader from the vertex and fragment paths
-	BaseShader(const char* vertexPath, const char* fragmentPath);
+	// Constructor reads and builds the shader from the vertex and fragment paths, using the binary cache if given
+	BaseShader(const char* vertexPath, const char* fragmentPath, ProgramBinaryCache* cache = NULL, BuildMode mode = BUILD_BLOCKING);
+
+	// Constructor for a variant with defines injected after the #version line of each stage
+	BaseShader(const char* vertexPath, const char* fragmentPath, const ShaderDefines &defines,
+		ProgramBinaryCache* cache = NULL, BuildMode mode = BUILD_BLOCKING);
+
+	// Constructor for sources that were already preprocessed, for example by preprocessShaderBatch
+	BaseShader(const char* vertexPath, const char* fragmentPath, const ShaderDefines &defines,
+		const ShaderSource &vertexSource, const ShaderSource &fragmentSource,
+		ProgramBinaryCache* cache = NULL, BuildMode mode = BUILD_BLOCKING);
+
+	// Destructor deletes the program and anything still being built
+	~BaseShader();
+
+	// Let the driver compile on background threads if GL_KHR_parallel_shader_compile is available
+	static bool enableParallelCompile();
+
+	// Poll an async build without blocking, finishing it once the driver reports completion
+	bool isReady();
+
+	// Block until the build is complete, then check for errors and list the uniforms
+	void finishBuild();
+
+	// True while the build started by the constructor is unfinished
+	bool isBuilding() const;
+
+	// True if the sources could not be loaded or the last build did not compile and link
+	bool hasFailed() const;
+
+	// Preprocess both stages from disk with this shader's defines, safe to call from any thread
+	bool loadSources(ShaderSource &vertexCode, ShaderSource &fragmentCode) const;
+
+	// Compile, link and status query times of the last build or reload that finished
+	const ProgramTiming &getBuildTiming() const;
+
+	// Vertex and fragment source paths the shader was built from
+	const std::string &getVertexPath() const;
+	const std::string &getFragmentPath() const;
+
+	// Every file read to build the shader, including the ones pulled in by #include
+	const std::vector<std::string> &getSourceFiles() const;
+
+	// Replace the source files with the ones read for the last reload swapped in by pollReload. Another thread
+	// may be reading getSourceFiles, so the caller must hold whatever lock guards those reads
+	void updateSourceFiles();
+
+	// Start an async build of new sources into a separate program, replacing any reload in progress
+	void beginReload(const ShaderSource &vertexCode, const ShaderSource &fragmentCode);
+
+	// Poll a reload, swapping in the new program if it linked, true if a swap happened. Only a reload from
+	// buildReload or one polled with parallel compile available is checked without blocking. Reloads wait
+	// until the first build has finished
+	bool pollReload();
+
+	// Compile and link new sources into a separate program and wait for the result, on a thread whose context
+	// shares objects with the render thread's. The result is given to adoptReload on the render thread
+	ReloadBuild buildReload(const ShaderSource &vertexCode, const ShaderSource &fragmentCode) const;
+
+	// Take over a reload made by buildReload, replacing any reload in progress. The next pollReload swaps it in
+	void adoptReload(const ReloadBuild &build);
+
+	// Delete a reload made by buildReload that will not be adopted
+	static void deleteReload(const ReloadBuild &build);
 
 	// Activate/Use the shader
 	void use();
@@ -35,9 +143,121 @@ public:
 	// Utility function to set float
 	void setFloat(const std::string &name, float value) const;
 
+	// Look up a uniform location in the table built at link time, -1 if it is not active. Arrays may be named
+	// with or without "[0]"
+	int getUniformLocation(const std::string &name) const;
+
+	// Resolve a typed handle for a uniform, invalid if it is not active or its type differs
+	template <typename T>
+	UniformHandle<T> getUniform(UniformName name) const {
+		int slot = findUniformSlot(name.hash, name.name, name.length);
+		if (slot != -1 && !UniformTraits<T>::matches(uniforms[slot].type)) {
+			std::cout << "Error: uniform " << name.name << " does not match the requested type" << std::endl;
+			slot = -1;
+		}
+		return UniformHandle<T>(slot);
+	}
+
+	// Set a uniform through a resolved handle without any name lookup
+	void set(UniformHandle<bool> uniform, bool value) const;
+	void set(UniformHandle<int> uniform, int value) const;
+	void set(UniformHandle<float> uniform, float value) const;
+
+	// Look up a uniform block found at link time, NULL if it is not active
+	const UniformBlockInfo* getUniformBlock(const std::string &name) const;
+
+	// Attach a uniform block to a buffer binding point, kept across hot reloads
+	void bindUniformBlock(const std::string &name, unsigned int binding);
+
+	// Forget the last values sent, needed after uniforms are set with raw glUniform calls
+	void invalidateShadowValues();
+
+	// Uniform calls issued and skipped by all shaders since the last reset, reset once per frame
+	static UniformCallStats getFrameStats();
+	static void resetFrameStats();
+
 private:
+	// A shader owns its program object, so it cannot be copied
+	BaseShader(const BaseShader &);
+	BaseShader &operator=(const BaseShader &);
+
+	// Whether the driver can report build completion without blocking
+	static bool parallelCompile;
+
+	static UniformCallStats frameStats;
+
+	std::string vertexPath, fragmentPath;
+	ShaderDefines defines;
+	std::vector<std::string> sourceFiles;
+
+	// Shaders and cache details held until an async build is finished
+	bool building;
+	unsigned int pendingVertex, pendingFragment;
+	ProgramBinaryCache* cache;
+	unsigned long long cacheKey;
+	std::chrono::high_resolution_clock::time_point buildStart;
+	ProgramTiming timing;
+	bool failed;
+
+	// Replacement program being built by a hot reload
+	bool reloading;
+	ReloadBuild reload;
+	// Files of the last reload swapped in, until updateSourceFiles takes them
+	std::vector<std::string> reloadedFiles;
+
+	// Active uniform reported by glGetActiveUniform after linking
+	struct UniformInfo {
+		std::string name;
+		unsigned int hash;
+		int location;
+		GLenum type;
+		int size;
+		// Last value sent to the program, as raw bits so int and float share the comparison
+		mutable bool hasValue;
+		mutable unsigned int shadowValue;
+	};
+
+	// Active uniforms, and an open addressing table of indices into it keyed by name hash
+	std::vector<UniformInfo> uniforms;
+	std::vector<int> uniformSlots;
+
+	// Active uniform blocks, few enough per program to search linearly
+	std::vector<UniformBlockInfo> uniformBlocks;
+
+	// Helper function to read the sources unless they were given, and start the build
+	void build(BuildMode mode, const ShaderSource* vertexSource, const ShaderSource* fragmentSource);
+
 	// Helper function to check compile and linking status
-	void checkCompileErrors(unsigned int shader, std::string type);
+	static bool checkCompileErrors(unsigned int shader, std::string type);
+
+	// Helper function to create, compile and link the stages into the program without querying their status
+	static void submitProgram(unsigned int program, const ShaderSource &vertexCode, const ShaderSource &fragmentCode,
+		unsigned int &vertex, unsigned int &fragment, ProgramTiming &timing);
+
+	// Helper function to check both stages and the program, timing each status query
+	static bool checkBuild(unsigned int vertex, unsigned int fragment, unsigned int program, ProgramTiming &buildTiming);
+
+	// Helper function to create a reload program and submit the new sources to it without querying their status
+	void submitReload(ReloadBuild &build, const ShaderSource &vertexCode, const ShaderSource &fragmentCode) const;
+
+	// Helper function to throw away an unfinished or failed reload
+	void discardReload();
+
+	// Helper function to copy one uniform value from a program into the currently bound program
+	static void copyUniformValue(unsigned int fromProgram, int fromLocation, int toLocation, GLenum type);
+
+	// Helper function to record the value about to be sent, false if the program already holds it
+	bool updateShadowValue(int slot, unsigned int bits) const;
+
+	// Helper function to find the table index of a uniform by name hash, -1 if it is not active. Array names are
+	// accepted with or without "[0]"
+	int findUniformSlot(unsigned int hash, const char* name, size_t length) const;
+
+	// Helper function to list the active uniforms of the linked program into the table
+	void buildUniformTable();
+
+	// Helper function to list the active uniform blocks and their members, restoring earlier bindings
+	void buildUniformBlockTable();
 };
 
 #endif
\ No newline at end of file
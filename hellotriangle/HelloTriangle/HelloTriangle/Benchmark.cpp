@@ -0,0 +1,977 @@
+/*
+ * Benchmark.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Microbenchmarks run by passing --benchmark on the command line
+ */
+
+#include "Benchmark.hpp"
+
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+// Nanoseconds elapsed since the start time point
+static double elapsedNanoseconds(BenchClock::time_point start) {
+	return std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+}
+
+// Fill a grid of quads covering the window, each with its own mix and tint
+static void makeQuadInstances(std::vector<QuadInstance> &instances, int count) {
+	int side = (int)std::ceil(std::sqrt((double)count));
+	float cell = 2.0f / side;
+	instances.resize(count);
+	for (int i = 0; i < count; i++) {
+		QuadInstance &quad = instances[i];
+		int column = i % side, row = i / side;
+		quad.x = -1.0f + cell * (column + 0.5f);
+		quad.y = -1.0f + cell * (row + 0.5f);
+		quad.scale = cell;
+		quad.rotation = 0.1f * i;
+		quad.textureMix = (float)column / side;
+		quad.tint[0] = 1.0f;
+		quad.tint[1] = 0.5f + 0.5f * row / side;
+		quad.tint[2] = 1.0f;
+		quad.tint[3] = 1.0f;
+	}
+}
+
+// Compare setting the textureMix uniform through glGetUniformLocation on every call against the cached table and a handle
+void benchmarkUniformUpdates(BaseShader &shader, int updatesPerFrame, int frames) {
+	const std::string name = "textureMix";
+	shader.use();
+	double totalCalls = (double)updatesPerFrame * frames;
+
+	// Old path, a driver string lookup for every update
+	glFinish();
+	BenchClock::time_point start = BenchClock::now();
+	for (int frame = 0; frame < frames; frame++) {
+		for (int i = 0; i < updatesPerFrame; i++) {
+			glUniform1f(glGetUniformLocation(shader.ID, name.c_str()), (float)i / updatesPerFrame);
+		}
+	}
+	glFinish();
+	double lookupTime = elapsedNanoseconds(start);
+
+	// New path, location resolved from the table built at link time
+	start = BenchClock::now();
+	for (int frame = 0; frame < frames; frame++) {
+		for (int i = 0; i < updatesPerFrame; i++) {
+			shader.setFloat(name, (float)i / updatesPerFrame);
+		}
+	}
+	glFinish();
+	double cachedTime = elapsedNanoseconds(start);
+
+	// Handle path, resolved once with no string work per update
+	UniformHandle<float> handle = shader.getUniform<float>(UNIFORM_NAME("textureMix"));
+	start = BenchClock::now();
+	for (int frame = 0; frame < frames; frame++) {
+		for (int i = 0; i < updatesPerFrame; i++) {
+			shader.set(handle, (float)i / updatesPerFrame);
+		}
+	}
+	glFinish();
+	double handleTime = elapsedNanoseconds(start);
+
+	// Redundant path, the same value on every update so the shadow copy drops all but the first
+	shader.invalidateShadowValues();
+	BaseShader::resetFrameStats();
+	start = BenchClock::now();
+	for (int frame = 0; frame < frames; frame++) {
+		for (int i = 0; i < updatesPerFrame; i++) {
+			shader.set(handle, 0.5f);
+		}
+	}
+	glFinish();
+	double redundantTime = elapsedNanoseconds(start);
+	UniformCallStats stats = BaseShader::getFrameStats();
+
+	std::cout << "Benchmark: uniform updates (" << updatesPerFrame << " per frame, " << frames << " frames)" << std::endl;
+	std::cout << "  glGetUniformLocation per call: " << lookupTime / totalCalls << " ns/call, "
+		<< lookupTime / frames / 1000000.0 << " ms/frame" << std::endl;
+	std::cout << "  cached uniform table:          " << cachedTime / totalCalls << " ns/call, "
+		<< cachedTime / frames / 1000000.0 << " ms/frame" << std::endl;
+	std::cout << "  UniformHandle<float>:          " << handleTime / totalCalls << " ns/call, "
+		<< handleTime / frames / 1000000.0 << " ms/frame" << std::endl;
+	std::cout << "  unchanged value with handle:   " << redundantTime / totalCalls << " ns/call, "
+		<< stats.issued << " issued, " << stats.skipped << " skipped" << std::endl;
+}
+
+// Stream and draw 1000 to maxInstances quads in steps of 10x with one instanced draw per frame, reporting frame time
+void benchmarkInstancedQuads(BaseShader &shader, InstancedQuads &quads, int maxInstances, int frames) {
+	shader.use();
+	std::vector<QuadInstance> instances;
+	std::cout << "Benchmark: instanced quads (" << frames << " frames per count)" << std::endl;
+	for (int count = 1000; count <= maxInstances; count *= 10) {
+		makeQuadInstances(instances, count);
+
+		// Warm up so buffer growth and first-draw shader patching are not timed
+		quads.upload(instances);
+		quads.draw();
+		glFinish();
+
+		// Frames are not finished one by one, so the CPU can run ahead until the stream buffer fences stop it
+		double uploadTime = 0.0;
+		BenchClock::time_point framesStart = BenchClock::now();
+		for (int frame = 0; frame < frames; frame++) {
+			BenchClock::time_point start = BenchClock::now();
+			// Spin every quad so each frame streams new instance data
+			for (int i = 0; i < count; i++) {
+				instances[i].rotation += 0.01f;
+			}
+			quads.upload(instances);
+			uploadTime += elapsedNanoseconds(start);
+			glClear(GL_COLOR_BUFFER_BIT);
+			quads.draw();
+		}
+		glFinish();
+		double frameTime = elapsedNanoseconds(framesStart);
+
+		double frameMs = frameTime / frames / 1000000.0;
+		std::cout << "  " << count << " quads: " << frameMs << " ms/frame ("
+			<< uploadTime / frames / 1000000.0 << " ms update and upload), "
+			<< count / frameMs / 1000.0 << " M quads/s" << std::endl;
+	}
+	std::cout << "  ";
+	quads.getStream().printReport();
+}
+
+// Queue 10k, 100k and 1M sprites spread over two shaders and two textures, reporting sprites per millisecond
+void benchmarkSpriteBatch(SpriteBatch &batch, BaseShader* shaders[2], const unsigned int textures[2], int frames) {
+	std::cout << "Benchmark: sprite batch (" << frames << " frames per count)" << std::endl;
+	std::vector<Sprite> sprites;
+	for (int count = 10000; count <= 1000000; count *= 10) {
+		// Scatter the sprites and interleave their state, the worst order to submit them in
+		sprites.resize(count);
+		unsigned int seed = 12345u;
+		for (int i = 0; i < count; i++) {
+			Sprite &sprite = sprites[i];
+			seed = seed * 1664525u + 1013904223u;
+			sprite.x = (seed >> 8) / 16777216.0f * 2.0f - 1.0f;
+			seed = seed * 1664525u + 1013904223u;
+			sprite.y = (seed >> 8) / 16777216.0f * 2.0f - 1.0f;
+			sprite.width = sprite.height = 0.02f;
+			sprite.u0 = sprite.v0 = 0.0f;
+			sprite.u1 = sprite.v1 = 1.0f;
+			sprite.color[0] = sprite.color[1] = sprite.color[2] = 1.0f;
+			sprite.shader = shaders[i % 2];
+			sprite.texture = textures[(i / 2) % 2];
+		}
+
+		batch.resetStats();
+		BenchClock::time_point start = BenchClock::now();
+		for (int frame = 0; frame < frames; frame++) {
+			glClear(GL_COLOR_BUFFER_BIT);
+			batch.begin();
+			for (int i = 0; i < count; i++) {
+				batch.draw(sprites[i]);
+			}
+			batch.end();
+		}
+		glFinish();
+		double frameMs = elapsedNanoseconds(start) / frames / 1000000.0;
+		SpriteBatchStats stats = batch.getStats();
+
+		std::cout << "  " << count << " sprites: " << frameMs << " ms/frame, " << count / frameMs
+			<< " sprites/ms, " << stats.drawCalls / frames << " draw calls/frame" << std::endl;
+	}
+	std::cout << "  ";
+	batch.getStream().printReport();
+}
+
+// Helper function to fill a gridSide x gridSide vertex grid in [-1, 1] with a color gradient, texture coordinates
+// in [0, 1] and a tilted normal per vertex, along with its triangle list
+static void makeGrid(int gridSide, std::vector<float> &positions, std::vector<float> &colors,
+	std::vector<float> &texCoords, std::vector<float> &normals, std::vector<unsigned int> &indices) {
+	size_t vertexCount = (size_t)gridSide * gridSide;
+	positions.resize(vertexCount * 3);
+	colors.resize(vertexCount * 3);
+	texCoords.resize(vertexCount * 2);
+	normals.resize(vertexCount * 3);
+	for (int row = 0; row < gridSide; row++) {
+		for (int column = 0; column < gridSide; column++) {
+			size_t i = (size_t)row * gridSide + column;
+			float u = (float)column / (gridSide - 1), v = (float)row / (gridSide - 1);
+			positions[i * 3 + 0] = u * 2.0f - 1.0f;
+			positions[i * 3 + 1] = v * 2.0f - 1.0f;
+			positions[i * 3 + 2] = 0.0f;
+			colors[i * 3 + 0] = u;
+			colors[i * 3 + 1] = v;
+			colors[i * 3 + 2] = 1.0f - u;
+			texCoords[i * 2 + 0] = u;
+			texCoords[i * 2 + 1] = v;
+			float length = std::sqrt(1.0f + (u - 0.5f) * (u - 0.5f) + (v - 0.5f) * (v - 0.5f));
+			normals[i * 3 + 0] = (u - 0.5f) / length;
+			normals[i * 3 + 1] = (v - 0.5f) / length;
+			normals[i * 3 + 2] = 1.0f / length;
+		}
+	}
+	indices.clear();
+	indices.reserve((size_t)(gridSide - 1) * (gridSide - 1) * 6);
+	for (int row = 0; row < gridSide - 1; row++) {
+		for (int column = 0; column < gridSide - 1; column++) {
+			unsigned int corner = (unsigned int)(row * gridSide + column);
+			indices.push_back(corner);
+			indices.push_back(corner + 1);
+			indices.push_back(corner + gridSide);
+			indices.push_back(corner + 1);
+			indices.push_back(corner + gridSide + 1);
+			indices.push_back(corner + gridSide);
+		}
+	}
+}
+
+// Helper function to upload a packed vertex buffer into a new vertex array laid out by format
+static unsigned int createMesh(const VertexFormat &format, const std::vector<unsigned char> &vertices, unsigned int &vertexBuffer) {
+	unsigned int vertexArray;
+	glGenVertexArrays(1, &vertexArray);
+	glGenBuffers(1, &vertexBuffer);
+	GLState::bindVertexArray(vertexArray);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size(), vertices.data(), GL_STATIC_DRAW);
+	format.apply(vertexArray, vertexBuffer);
+	return vertexArray;
+}
+
+// Draw a gridSide x gridSide vertex mesh from a float layout and a quantized layout, reporting size and vertex throughput
+void benchmarkVertexFormats(BaseShader &shader, int gridSide, int frames) {
+	size_t vertexCount = (size_t)gridSide * gridSide;
+	std::vector<float> positions, colors, texCoords, normals;
+	std::vector<unsigned int> indices;
+	makeGrid(gridSide, positions, colors, texCoords, normals, indices);
+	unsigned int indexBuffer;
+	glGenBuffers(1, &indexBuffer);
+	GLState::bindVertexArray(0);
+	GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+
+	// Same attributes as the quad, plus a normal the shader does not read but a lit mesh would
+	VertexFormat formats[2];
+	formats[0].add(0, 3, VertexFormat::FLOAT32).add(1, 3, VertexFormat::FLOAT32)
+		.add(2, 2, VertexFormat::FLOAT32).add(6, 3, VertexFormat::FLOAT32);
+	formats[1].add(0, 3, VertexFormat::HALF).add(1, 3, VertexFormat::UNORM8)
+		.add(2, 2, VertexFormat::UNORM16).add(6, 3, VertexFormat::SNORM_10_10_10_2);
+	const char* names[2] = { "float32", "quantized" };
+
+	std::vector<const float*> sources;
+	sources.push_back(positions.data());
+	sources.push_back(colors.data());
+	sources.push_back(texCoords.data());
+	sources.push_back(normals.data());
+
+	std::cout << "Benchmark: vertex formats (" << vertexCount << " vertices, " << indices.size() / 3
+		<< " triangles, " << frames << " frames)" << std::endl;
+	shader.use();
+	for (int f = 0; f < 2; f++) {
+		std::vector<unsigned char> vertices;
+		BenchClock::time_point start = BenchClock::now();
+		size_t clamped = formats[f].pack(sources, vertexCount, vertices);
+		double packMs = elapsedNanoseconds(start) / 1000000.0;
+
+		// Worst position error introduced by the storage, read back from the packed data
+		float maxError = 0.0f;
+		if (formats[f].getAttributes()[0].storage == VertexFormat::HALF) {
+			for (size_t i = 0; i < vertexCount * 3; i++) {
+				unsigned short half;
+				std::memcpy(&half, vertices.data() + (i / 3) * formats[f].stride() + (i % 3) * 2, 2);
+				maxError = std::max(maxError, std::fabs(VertexFormat::halfToFloat(half) - positions[i]));
+			}
+		}
+
+		unsigned int vertexBuffer;
+		unsigned int vertexArray = createMesh(formats[f], vertices, vertexBuffer);
+		GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+		glDrawElements(GL_TRIANGLES, (GLsizei)indices.size(), GL_UNSIGNED_INT, 0);
+		glFinish();
+
+		start = BenchClock::now();
+		for (int frame = 0; frame < frames; frame++) {
+			glClear(GL_COLOR_BUFFER_BIT);
+			glDrawElements(GL_TRIANGLES, (GLsizei)indices.size(), GL_UNSIGNED_INT, 0);
+		}
+		glFinish();
+		double frameMs = elapsedNanoseconds(start) / frames / 1000000.0;
+
+		std::cout << "  " << names[f] << ": " << formats[f].stride() << " bytes/vertex, "
+			<< vertices.size() / (1024.0 * 1024.0) << " MB, " << frameMs << " ms/frame, "
+			<< vertexCount / frameMs / 1000.0 << " M vertices/s, pack " << packMs << " ms";
+		if (maxError > 0.0f) {
+			std::cout << ", max position error " << maxError;
+		}
+		if (clamped > 0) {
+			std::cout << ", " << clamped << " values clamped";
+		}
+		std::cout << std::endl;
+
+		GLState::deleteVertexArray(vertexArray);
+		GLState::deleteBuffer(vertexBuffer);
+	}
+	GLState::deleteBuffer(indexBuffer);
+}
+
+// Draw a gridSide x gridSide vertex mesh with 32-bit indices, split into 16-bit pieces and as restarted strips
+void benchmarkIndexWidths(BaseShader &shader, int gridSide, int frames) {
+	size_t vertexCount = (size_t)gridSide * gridSide;
+	std::vector<float> positions, colors, texCoords, normals;
+	std::vector<unsigned int> triangles;
+	makeGrid(gridSide, positions, colors, texCoords, normals, triangles);
+
+	// One strip per row of quads, each ended by a restart
+	std::vector<unsigned int> strips;
+	for (int row = 0; row < gridSide - 1; row++) {
+		for (int column = 0; column < gridSide; column++) {
+			strips.push_back((unsigned int)((row + 1) * gridSide + column));
+			strips.push_back((unsigned int)(row * gridSide + column));
+		}
+		strips.push_back(IndexBuffer::RESTART);
+	}
+
+	VertexFormat format;
+	format.add(0, 3, VertexFormat::FLOAT32).add(1, 3, VertexFormat::FLOAT32).add(2, 2, VertexFormat::FLOAT32);
+	std::vector<const float*> sources;
+	sources.push_back(positions.data());
+	sources.push_back(colors.data());
+	sources.push_back(texCoords.data());
+	std::vector<unsigned char> vertices;
+	format.pack(sources, vertexCount, vertices);
+
+	std::cout << "Benchmark: index widths (" << vertexCount << " vertices, " << triangles.size() / 3
+		<< " triangles, " << frames << " frames)" << std::endl;
+	shader.use();
+	const char* names[3] = { "32-bit list", "16-bit split list", "restarted strips" };
+	for (int m = 0; m < 3; m++) {
+		unsigned int vertexBuffer;
+		std::vector<unsigned int> remap;
+		std::vector<unsigned char> remapped;
+		IndexBuffer indexBuffer;
+		unsigned int vertexArray;
+		if (m == 1) {
+			// The split decides the vertex order, so the indices go in before the vertex buffer is built
+			glGenVertexArrays(1, &vertexArray);
+			indexBuffer.uploadTriangles(vertexArray, triangles, vertexCount, format.stride(), remap);
+			if (remap.empty()) {
+				remapped = vertices;
+			}
+			else {
+				IndexBuffer::remapVertices(vertices.data(), format.stride(), remap, remapped);
+			}
+			glGenBuffers(1, &vertexBuffer);
+			GLState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+			glBufferData(GL_ARRAY_BUFFER, remapped.size(), remapped.data(), GL_STATIC_DRAW);
+			format.apply(vertexArray, vertexBuffer);
+		}
+		else {
+			vertexArray = createMesh(format, vertices, vertexBuffer);
+			if (m == 0) {
+				indexBuffer.upload(vertexArray, triangles, vertexCount, GL_TRIANGLES);
+			}
+			else {
+				indexBuffer.upload(vertexArray, strips, vertexCount, GL_TRIANGLE_STRIP);
+			}
+		}
+		size_t vertexBytes = m == 1 ? remapped.size() : vertices.size();
+
+		indexBuffer.draw();
+		glFinish();
+		BenchClock::time_point start = BenchClock::now();
+		for (int frame = 0; frame < frames; frame++) {
+			glClear(GL_COLOR_BUFFER_BIT);
+			indexBuffer.draw();
+		}
+		glFinish();
+		double frameMs = elapsedNanoseconds(start) / frames / 1000000.0;
+
+		std::cout << "  " << names[m] << ": " << IndexBuffer::typeSize(indexBuffer.getType()) << " bytes/index, "
+			<< indexBuffer.getByteSize() / (1024.0 * 1024.0) << " MB indices, " << vertexBytes / (1024.0 * 1024.0)
+			<< " MB vertices, " << indexBuffer.getRanges().size() << " pieces, " << frameMs << " ms/frame" << std::endl;
+
+		GLState::deleteVertexArray(vertexArray);
+		GLState::deleteBuffer(vertexBuffer);
+	}
+	// Leave restart off so later 16-bit draws can use index 0xFFFF as a vertex
+	GLState::setEnabled(GL_PRIMITIVE_RESTART, false);
+}
+
+// Helper function to write a UV sphere as an OBJ file, with the triangles in a shuffled order like a merged export
+static bool writeSphereObj(const std::string &path, int segments, int rings) {
+	std::ofstream file(path.c_str());
+	if (!file) {
+		std::cout << "Error: cannot write " << path << std::endl;
+		return false;
+	}
+	const float pi = 3.14159265f;
+	for (int ring = 0; ring <= rings; ring++) {
+		float theta = pi * ring / rings;
+		for (int segment = 0; segment <= segments; segment++) {
+			float phi = 2.0f * pi * segment / segments;
+			float x = std::sin(theta) * std::cos(phi), y = std::cos(theta), z = std::sin(theta) * std::sin(phi);
+			file << "v " << x * 0.8f << " " << y * 0.8f << " " << z * 0.8f << "\n";
+			file << "vt " << (float)segment / segments << " " << 1.0f - (float)ring / rings << "\n";
+			file << "vn " << x << " " << y << " " << z << "\n";
+		}
+	}
+	std::vector<unsigned int> quads;
+	for (int ring = 0; ring < rings; ring++) {
+		for (int segment = 0; segment < segments; segment++) {
+			quads.push_back((unsigned int)(ring * (segments + 1) + segment + 1));
+		}
+	}
+	// A fixed linear congruential shuffle so every run loads the same file
+	unsigned int seed = 12345u;
+	for (size_t i = quads.size() - 1; i > 0; i--) {
+		seed = seed * 1664525u + 1013904223u;
+		std::swap(quads[i], quads[seed % (i + 1)]);
+	}
+	for (size_t i = 0; i < quads.size(); i++) {
+		unsigned int a = quads[i], b = a + 1, c = a + segments + 2, d = a + segments + 1;
+		file << "f " << a << "/" << a << "/" << a << " " << d << "/" << d << "/" << d << " "
+			<< c << "/" << c << "/" << c << " " << b << "/" << b << "/" << b << "\n";
+	}
+	return true;
+}
+
+// Load an OBJ file as it is and optimized, reporting load throughput and cache miss ratios and timing the draws.
+// An empty path writes out a generated sphere to load instead
+void benchmarkObjLoader(BaseShader &shader, const std::string &path, int frames) {
+	std::string meshPath = path;
+	if (meshPath.empty()) {
+		meshPath = "benchmark_sphere.obj";
+		if (!writeSphereObj(meshPath, 512, 256)) {
+			return;
+		}
+	}
+
+	std::cout << "Benchmark: OBJ loader (" << meshPath << ", " << frames << " frames)" << std::endl;
+	shader.use();
+	const char* names[2] = { "as loaded", "optimized" };
+	for (int optimize = 0; optimize < 2; optimize++) {
+		ObjMesh mesh;
+		if (!mesh.load(meshPath, optimize == 1)) {
+			break;
+		}
+		mesh.printReport(names[optimize]);
+
+		IndexBuffer indexBuffer;
+		unsigned int vertexBuffer;
+		unsigned int vertexArray = mesh.createVertexArray(indexBuffer, vertexBuffer);
+		indexBuffer.draw();
+		glFinish();
+		BenchClock::time_point start = BenchClock::now();
+		for (int frame = 0; frame < frames; frame++) {
+			glClear(GL_COLOR_BUFFER_BIT);
+			indexBuffer.draw();
+		}
+		glFinish();
+		std::cout << "  " << elapsedNanoseconds(start) / frames / 1000000.0 << " ms/frame" << std::endl;
+
+		GLState::deleteVertexArray(vertexArray);
+		GLState::deleteBuffer(vertexBuffer);
+	}
+	if (path.empty()) {
+		std::remove(meshPath.c_str());
+	}
+}
+
+// Helper function to build a UV sphere of radius 0.8 with a seam along one meridian
+static void makeSphere(int segments, int rings, std::vector<MeshVertex> &vertices, std::vector<unsigned int> &indices) {
+	const float pi = 3.14159265f;
+	vertices.clear();
+	indices.clear();
+	for (int ring = 0; ring <= rings; ring++) {
+		float theta = pi * ring / rings;
+		for (int segment = 0; segment <= segments; segment++) {
+			float phi = 2.0f * pi * segment / segments;
+			float normal[3] = { std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) };
+			MeshVertex vertex;
+			for (int a = 0; a < 3; a++) {
+				vertex.position[a] = normal[a] * 0.8f;
+				vertex.color[a] = normal[a] * 0.5f + 0.5f;
+				vertex.normal[a] = normal[a];
+			}
+			vertex.texCoord[0] = (float)segment / segments;
+			vertex.texCoord[1] = 1.0f - (float)ring / rings;
+			vertices.push_back(vertex);
+		}
+	}
+	for (int ring = 0; ring < rings; ring++) {
+		for (int segment = 0; segment < segments; segment++) {
+			unsigned int a = (unsigned int)(ring * (segments + 1) + segment), b = a + 1;
+			unsigned int c = a + segments + 2, d = a + segments + 1;
+			indices.push_back(a);
+			indices.push_back(d);
+			indices.push_back(c);
+			indices.push_back(a);
+			indices.push_back(c);
+			indices.push_back(b);
+		}
+	}
+}
+
+// Draw spheres at a range of distances at full detail and then with LOD selection, reporting triangles drawn,
+// frame times and how often levels switch with and without hysteresis. The shader must be the instanced variant
+void benchmarkMeshLod(BaseShader &shader, float viewportHeight, int frames) {
+	std::vector<MeshVertex> vertices;
+	std::vector<unsigned int> indices;
+	// 512 x 256 quads, 262,144 triangles, so the chain runs from 262k down to about 8k
+	makeSphere(512, 256, vertices, indices);
+
+	BenchClock::time_point start = BenchClock::now();
+	MeshLod lod;
+	lod.build(indices, vertices[0].position, sizeof(MeshVertex), vertices.size());
+	double buildMs = elapsedNanoseconds(start) / 1000000.0;
+
+	unsigned int vertexArray, vertexBuffer;
+	glGenVertexArrays(1, &vertexArray);
+	glGenBuffers(1, &vertexBuffer);
+	GLState::bindVertexArray(vertexArray);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(MeshVertex), vertices.data(), GL_STATIC_DRAW);
+	ObjMesh::getFormat().apply(vertexArray, vertexBuffer);
+	lod.upload(vertexArray, vertices.size());
+
+	std::cout << "Benchmark: mesh LOD (" << frames << " frames, chain built in " << buildMs << " ms)" << std::endl;
+	lod.printReport("sphere");
+
+	// A 16 x 16 grid of spheres from 2 to 64 units away under a 90 degree field of view
+	const int side = 16, objectCount = side * side;
+	const float radius = 0.8f, fovY = 1.5707963f;
+	std::vector<float> distances(objectCount);
+	unsigned int seed = 12345u;
+	for (int i = 0; i < objectCount; i++) {
+		seed = seed * 1664525u + 1013904223u;
+		distances[i] = 2.0f + 62.0f * (seed >> 8) / 16777216.0f;
+	}
+	LodSelector selector(120.0f, 0.5f, 0.1f);
+	LodSelector noHysteresis(120.0f, 0.5f, 0.0f);
+
+	// The instance attribute arrays are off in this vertex array, so the shader reads these constant values
+	glVertexAttrib1f(4, 0.0f);
+	glVertexAttrib4f(5, 1.0f, 1.0f, 1.0f, 1.0f);
+	shader.use();
+
+	const char* names[2] = { "full detail", "LOD" };
+	for (int mode = 0; mode < 2; mode++) {
+		std::vector<int> levels(objectCount, 0), levelsWithout(objectCount, 0);
+		size_t triangles = 0, switches = 0, switchesWithout = 0;
+		glFinish();
+		start = BenchClock::now();
+		for (int frame = 0; frame < frames; frame++) {
+			glClear(GL_COLOR_BUFFER_BIT);
+			for (int i = 0; i < objectCount; i++) {
+				// Each sphere drifts a little back and forth, which is where hysteresis matters
+				float distance = distances[i] * (1.0f + 0.05f * std::sin(frame * 0.2f + i));
+				float size = LodSelector::projectedSize(radius, distance, fovY, viewportHeight);
+				int level = 0;
+				if (mode == 1) {
+					level = selector.select(levels[i], size, lod.getLevelCount());
+					switches += level != levels[i];
+					levels[i] = level;
+					int levelWithout = noHysteresis.select(levelsWithout[i], size, lod.getLevelCount());
+					switchesWithout += levelWithout != levelsWithout[i];
+					levelsWithout[i] = levelWithout;
+				}
+				// With tan(fovY / 2) at 1 the projected scale is simply one over the distance
+				glVertexAttrib4f(3, -0.9375f + (i % side) * 0.125f, -0.9375f + (i / side) * 0.125f, 1.0f / distance, 0.0f);
+				lod.draw(level);
+				triangles += lod.getLevel(level).count / 3;
+			}
+		}
+		glFinish();
+		double frameMs = elapsedNanoseconds(start) / frames / 1000000.0;
+
+		std::cout << "  " << names[mode] << ": " << triangles / frames << " triangles/frame, " << frameMs << " ms/frame";
+		if (mode == 1) {
+			std::cout << ", " << (double)switches / frames << " level switches/frame ("
+				<< (double)switchesWithout / frames << " without hysteresis)";
+		}
+		std::cout << std::endl;
+	}
+
+	GLState::deleteVertexArray(vertexArray);
+	GLState::deleteBuffer(vertexBuffer);
+}
+
+// Cull objectCount spheres and as many boxes scattered around a perspective camera with every kernel the CPU has,
+// reporting nanoseconds per object and checking each kernel finds the same visible set
+void benchmarkFrustumCulling(int objectCount, int repeats) {
+	std::cout << "Benchmark: frustum culling (" << objectCount << " objects, " << repeats << " repeats)" << std::endl;
+
+	// A 60 degree, 4:3 projection from the origin looking down -z, reaching 200 units
+	float nearPlane = 0.1f, farPlane = 200.0f;
+	float focal = 1.0f / std::tan(30.0f * 3.14159265f / 180.0f);
+	float projection[16] = {
+		focal / (4.0f / 3.0f), 0, 0, 0,
+		0, focal, 0, 0,
+		0, 0, (farPlane + nearPlane) / (nearPlane - farPlane), -1,
+		0, 0, 2.0f * farPlane * nearPlane / (nearPlane - farPlane), 0
+	};
+	Frustum frustum = Frustum::fromMatrix(projection);
+
+	// Objects fill a cube around the camera, so roughly a tenth of them fall inside
+	FrustumCuller spheres, boxes;
+	unsigned int seed = 1;
+	for (int i = 0; i < objectCount; i++) {
+		float values[4];
+		for (int j = 0; j < 4; j++) {
+			seed = seed * 1664525u + 1013904223u;
+			values[j] = (float)(seed >> 8) / (float)(1 << 24);
+		}
+		float x = values[0] * 400.0f - 200.0f, y = values[1] * 400.0f - 200.0f, z = values[2] * 400.0f - 200.0f;
+		float size = 0.5f + values[3] * 2.0f;
+		spheres.addSphere(i, x, y, z, size);
+		boxes.addBox(i, x, y, z, size, size * 0.5f, size * 2.0f);
+	}
+
+	FrustumCuller* sets[2] = { &spheres, &boxes };
+	const char* names[2] = { "spheres", "boxes" };
+	FrustumCuller::Path widest = FrustumCuller::detectPath();
+	std::vector<unsigned int> visible, reference;
+	visible.reserve(objectCount);
+	for (int set = 0; set < 2; set++) {
+		for (int path = FrustumCuller::SCALAR; path <= widest; path++) {
+			sets[set]->setPath((FrustumCuller::Path)path);
+			double best = 0.0;
+			for (int repeat = 0; repeat < repeats; repeat++) {
+				visible.clear();
+				BenchClock::time_point start = BenchClock::now();
+				sets[set]->cull(frustum, visible);
+				double elapsed = elapsedNanoseconds(start);
+				best = repeat == 0 ? elapsed : std::min(best, elapsed);
+			}
+			if (path == FrustumCuller::SCALAR) {
+				reference = visible;
+			}
+			else if (visible != reference) {
+				std::cout << "Error: " << FrustumCuller::pathName((FrustumCuller::Path)path) << " culling of "
+					<< names[set] << " disagrees with the scalar kernel" << std::endl;
+			}
+			std::cout << "  " << names[set] << ", " << FrustumCuller::pathName((FrustumCuller::Path)path) << ": "
+				<< best / objectCount << " ns/object, " << visible.size() << " visible" << std::endl;
+		}
+	}
+}
+
+// Animate a nodeCount node hierarchy changing 1% of the local transforms each frame, comparing the dirty update
+// against recomputing every world matrix, then streaming the matrices and drawing a quad per node.
+// The shader must be the instanced world matrix variant
+void benchmarkSceneGraph(BaseShader &shader, int nodeCount, int frames) {
+	std::cout << "Benchmark: scene graph (" << nodeCount << " nodes, 1% changed per frame, " << frames << " frames)" << std::endl;
+
+	// A root, a ring of branches around it and a ring of leaves around each branch
+	SceneGraph graph;
+	NodeTransform transform = NodeTransform::identity();
+	int root = graph.addNode(SceneGraph::NO_PARENT, transform);
+	int branchCount = (int)std::sqrt((double)nodeCount);
+	std::vector<int> branches;
+	for (int i = 0; i < branchCount; i++) {
+		float angle = 6.2831853f * i / branchCount;
+		transform = NodeTransform::identity();
+		transform.position[0] = 0.7f * std::cos(angle);
+		transform.position[1] = 0.7f * std::sin(angle);
+		transform.scale[0] = transform.scale[1] = transform.scale[2] = 0.05f;
+		branches.push_back(graph.addNode(root, transform));
+	}
+	int leafCount = nodeCount - 1 - branchCount;
+	for (int i = 0; i < leafCount; i++) {
+		float angle = 6.2831853f * i / (leafCount / branchCount + 1);
+		transform = NodeTransform::identity();
+		transform.position[0] = 2.0f * std::cos(angle);
+		transform.position[1] = 2.0f * std::sin(angle);
+		transform.scale[0] = transform.scale[1] = transform.scale[2] = 0.3f;
+		graph.addNode(branches[i * branchCount / leafCount], transform);
+	}
+	graph.update();
+
+	// The same nodes change in both modes, picked at random so some are branches that drag their leaves along
+	int changesPerFrame = nodeCount / 100;
+	std::vector<int> changes(changesPerFrame * frames);
+	unsigned int seed = 7u;
+	for (size_t i = 0; i < changes.size(); i++) {
+		seed = seed * 1664525u + 1013904223u;
+		changes[i] = (int)((seed >> 8) % (unsigned int)nodeCount);
+	}
+
+	const char* names[2] = { "dirty subtrees", "full recompute" };
+	for (int mode = 0; mode < 2; mode++) {
+		size_t recomputed = 0;
+		double updateNanoseconds = 0.0;
+		for (int frame = 0; frame < frames; frame++) {
+			for (int i = 0; i < changesPerFrame; i++) {
+				int node = changes[frame * changesPerFrame + i];
+				transform = graph.getLocal(node);
+				transform.setRotationZ(0.05f * frame + node);
+				graph.setLocal(node, transform);
+			}
+			if (mode == 1) {
+				graph.markAllDirty();
+			}
+			BenchClock::time_point start = BenchClock::now();
+			recomputed += graph.update();
+			updateNanoseconds += elapsedNanoseconds(start);
+		}
+		std::cout << "  " << names[mode] << ": " << recomputed / frames << " matrices/frame, "
+			<< updateNanoseconds / frames / 1000000.0 << " ms/frame" << std::endl;
+	}
+
+	// One quad drawn per node, placed by its world matrix under an identity camera
+	MeshVertex corners[4];
+	float positions[4][2] = { { 0.5f, 0.5f }, { 0.5f, -0.5f }, { -0.5f, -0.5f }, { -0.5f, 0.5f } };
+	for (int i = 0; i < 4; i++) {
+		MeshVertex vertex = { { positions[i][0], positions[i][1], 0.0f }, { 1.0f, 1.0f, 1.0f },
+			{ positions[i][0] + 0.5f, positions[i][1] + 0.5f }, { 0.0f, 0.0f, 1.0f } };
+		corners[i] = vertex;
+	}
+	std::vector<unsigned int> quadIndices = { 0, 1, 3, 1, 2, 3 };
+	unsigned int vertexArray, vertexBuffer;
+	glGenVertexArrays(1, &vertexArray);
+	glGenBuffers(1, &vertexBuffer);
+	GLState::bindVertexArray(vertexArray);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+	ObjMesh::getFormat().apply(vertexArray, vertexBuffer);
+	IndexBuffer indexBuffer;
+	indexBuffer.upload(vertexArray, quadIndices, 4, GL_TRIANGLES);
+	{
+		WorldInstances instances(vertexArray, graph.size(), indexBuffer.getType());
+
+		BlockLayout camera;
+		camera.add("viewProjection", GL_FLOAT_MAT4);
+		const BlockMember* viewProjection = camera.find("viewProjection");
+		camera.validate(shader, "Camera");
+		UniformRing cameraRing(camera.size() * 4);
+		shader.bindUniformBlock("Camera", 0);
+		const float identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+
+		// Mix and tint are constant attributes, the matrix rows are the only per-instance data
+		glVertexAttrib1f(4, 0.0f);
+		glVertexAttrib4f(5, 1.0f, 1.0f, 1.0f, 1.0f);
+		shader.use();
+		glFinish();
+		BenchClock::time_point start = BenchClock::now();
+		for (int frame = 0; frame < frames; frame++) {
+			for (int i = 0; i < changesPerFrame; i++) {
+				int node = changes[frame * changesPerFrame + i];
+				transform = graph.getLocal(node);
+				transform.setRotationZ(-0.05f * frame + node);
+				graph.setLocal(node, transform);
+			}
+			graph.update();
+
+			cameraRing.beginFrame();
+			UniformAllocation block = cameraRing.allocate(camera.size());
+			if (block.data != NULL) {
+				camera.write(block.data, *viewProjection, identity);
+				cameraRing.flush();
+				cameraRing.bind(0, block);
+			}
+			glClear(GL_COLOR_BUFFER_BIT);
+			instances.upload(graph);
+			instances.draw(6);
+			cameraRing.endFrame();
+		}
+		glFinish();
+		std::cout << "  update, upload and draw: " << elapsedNanoseconds(start) / frames / 1000000.0 << " ms/frame, "
+			<< instances.size() * sizeof(WorldMatrix) / 1024 << " KB of matrices" << std::endl;
+	}
+
+	GLState::deleteVertexArray(vertexArray);
+	GLState::deleteBuffer(vertexBuffer);
+}
+
+// Queue drawCount small quads spread over three shaders, four texture sets and eight vertex arrays in random order,
+// then submit them as queued and sorted by key, reporting state changes per frame and the time to sort and submit
+void benchmarkRenderQueue(BaseShader* shaders[3], const unsigned int textures[2], int drawCount, int frames) {
+	std::cout << "Benchmark: render queue (" << drawCount << " draws, " << frames << " frames)" << std::endl;
+
+	// Every vertex array holds the same tiny quad, so the draws cost little and the switches dominate
+	const int vertexArrayCount = 8;
+	MeshVertex corners[4];
+	float positions[4][2] = { { 0.02f, 0.02f }, { 0.02f, -0.02f }, { -0.02f, -0.02f }, { -0.02f, 0.02f } };
+	for (int i = 0; i < 4; i++) {
+		MeshVertex vertex = { { positions[i][0], positions[i][1], 0.0f }, { 1.0f, 1.0f, 1.0f },
+			{ positions[i][0] * 25.0f + 0.5f, positions[i][1] * 25.0f + 0.5f }, { 0.0f, 0.0f, 1.0f } };
+		corners[i] = vertex;
+	}
+	unsigned int quadIndices[6] = { 0, 1, 3, 1, 2, 3 };
+	unsigned int vertexArrays[vertexArrayCount];
+	unsigned int vertexBuffer, elementBuffer;
+	glGenVertexArrays(vertexArrayCount, vertexArrays);
+	glGenBuffers(1, &vertexBuffer);
+	glGenBuffers(1, &elementBuffer);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+	for (int i = 0; i < vertexArrayCount; i++) {
+		ObjMesh::getFormat().apply(vertexArrays[i], vertexBuffer);
+		GLState::bindVertexArray(vertexArrays[i]);
+		GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementBuffer);
+		if (i == 0) {
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quadIndices), quadIndices, GL_STATIC_DRAW);
+		}
+	}
+
+	const unsigned int textureSets[4][2] = {
+		{ textures[0], textures[1] }, { textures[1], textures[0] }, { textures[0], textures[0] }, { textures[1], textures[1] }
+	};
+	RenderQueue queue;
+	unsigned int seed = 99u;
+	for (int i = 0; i < drawCount; i++) {
+		unsigned int random[5];
+		for (int j = 0; j < 5; j++) {
+			seed = seed * 1664525u + 1013904223u;
+			random[j] = seed >> 8;
+		}
+		RenderItem item;
+		item.program = shaders[random[0] % 3]->ID;
+		item.textures[0] = textureSets[random[1] % 4][0];
+		item.textures[1] = textureSets[random[1] % 4][1];
+		item.vertexArray = vertexArrays[random[2] % vertexArrayCount];
+		item.mode = GL_TRIANGLES;
+		item.count = 6;
+		item.indexType = GL_UNSIGNED_INT;
+		item.indexOffset = 0;
+		item.baseVertex = 0;
+		item.instanceCount = 1;
+		item.layer = random[3] % 2;
+		// One draw in ten blends
+		item.translucent = random[4] % 10 == 0;
+		item.depth = (random[4] % 1000) / 1000.0f;
+		queue.add(item);
+	}
+
+	// The sort on its own, against std::sort of the same keys
+	std::vector<unsigned long long> keys(drawCount), keyScratch;
+	std::vector<unsigned int> values(drawCount), valueScratch;
+	std::vector<std::pair<unsigned long long, unsigned int> > pairs(drawCount);
+	double radixNanoseconds = 0.0, comparisonNanoseconds = 0.0;
+	for (int frame = 0; frame < frames; frame++) {
+		seed = 99u;
+		for (int i = 0; i < drawCount; i++) {
+			seed = seed * 1664525u + 1013904223u;
+			keys[i] = ((unsigned long long)seed << 32) | (seed * 2654435761u);
+			values[i] = i;
+			pairs[i] = std::make_pair(keys[i], (unsigned int)i);
+		}
+		BenchClock::time_point start = BenchClock::now();
+		RenderQueue::radixSort(keys, values, keyScratch, valueScratch);
+		radixNanoseconds += elapsedNanoseconds(start);
+		start = BenchClock::now();
+		std::sort(pairs.begin(), pairs.end());
+		comparisonNanoseconds += elapsedNanoseconds(start);
+	}
+	std::cout << "  sort: radix " << radixNanoseconds / frames / 1000.0 << " us, std::sort "
+		<< comparisonNanoseconds / frames / 1000.0 << " us" << std::endl;
+
+	const char* names[2] = { "submission order", "sorted" };
+	RenderQueue::SortMode modes[2] = { RenderQueue::SORT_NONE, RenderQueue::SORT_BY_KEY };
+	for (int mode = 0; mode < 2; mode++) {
+		queue.resetStats();
+		glFinish();
+		BenchClock::time_point start = BenchClock::now();
+		for (int frame = 0; frame < frames; frame++) {
+			glClear(GL_COLOR_BUFFER_BIT);
+			queue.submit(modes[mode]);
+		}
+		glFinish();
+		queue.printReport(names[mode]);
+		std::cout << "  " << elapsedNanoseconds(start) / frames / 1000000.0 << " ms/frame" << std::endl;
+	}
+	GLState::setEnabled(GL_BLEND, false);
+	GLState::depthMask(true);
+
+	for (int i = 0; i < vertexArrayCount; i++) {
+		GLState::deleteVertexArray(vertexArrays[i]);
+	}
+	GLState::deleteBuffer(vertexBuffer);
+	GLState::deleteBuffer(elementBuffer);
+}
+
+// Move, cull and build indirect commands for objectCount objects on 1 to maxWorkers workers, the commands waiting on
+// the culling through a dependency. Reports frame time, speedup over one worker and how many jobs were stolen
+void benchmarkJobSystem(unsigned int maxWorkers, int objectCount, int frames) {
+	std::cout << "Benchmark: job system (" << objectCount << " objects, 1 to " << maxWorkers << " workers, "
+		<< frames << " frames)" << std::endl;
+
+	// Objects orbit in front of the same camera as the culling benchmark
+	float nearPlane = 0.1f, farPlane = 200.0f;
+	float focal = 1.0f / std::tan(30.0f * 3.14159265f / 180.0f);
+	float projection[16] = {
+		focal / (4.0f / 3.0f), 0, 0, 0,
+		0, focal, 0, 0,
+		0, 0, (farPlane + nearPlane) / (nearPlane - farPlane), -1,
+		0, 0, 2.0f * farPlane * nearPlane / (nearPlane - farPlane), 0
+	};
+	Frustum frustum = Frustum::fromMatrix(projection);
+
+	FrustumCuller culler;
+	std::vector<float> orbits(objectCount), heights(objectCount);
+	unsigned int seed = 3u;
+	for (int i = 0; i < objectCount; i++) {
+		seed = seed * 1664525u + 1013904223u;
+		orbits[i] = 5.0f + 150.0f * (seed >> 8) / 16777216.0f;
+		seed = seed * 1664525u + 1013904223u;
+		heights[i] = -50.0f + 100.0f * (seed >> 8) / 16777216.0f;
+		culler.addSphere(i, 0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	const size_t batchSize = 16384;
+	size_t batchCount = (objectCount + batchSize - 1) / batchSize;
+	std::vector<std::vector<unsigned int> > visible(batchCount);
+	std::vector<DrawElementsIndirectCommand> commands(objectCount);
+	double singleWorkerMs = 0.0;
+	for (unsigned int workerCount = 1; workerCount <= maxWorkers; workerCount++) {
+		JobSystem jobs(workerCount);
+		size_t commandCount = 0;
+		BenchClock::time_point start = BenchClock::now();
+		for (int frame = 0; frame < frames; frame++) {
+			float time = frame * 0.01f;
+			JobCounter culled, built;
+			jobs.parallelFor(objectCount, batchSize, [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; i++) {
+					float angle = time * 50.0f / orbits[i] + i;
+					culler.setSphere(i, orbits[i] * std::cos(angle), heights[i], orbits[i] * std::sin(angle), 1.0f);
+				}
+				std::vector<unsigned int> &batchVisible = visible[begin / batchSize];
+				batchVisible.clear();
+				culler.cull(frustum, batchVisible, begin, end);
+			}, &culled);
+			jobs.parallelFor(batchCount, 1, [&](size_t batch, size_t) {
+				size_t offset = 0;
+				for (size_t i = 0; i < batch; i++) {
+					offset += visible[i].size();
+				}
+				for (size_t i = 0; i < visible[batch].size(); i++) {
+					DrawElementsIndirectCommand &command = commands[offset + i];
+					command.count = visible[batch][i] % 2 == 0 ? 6 : 3;
+					command.instanceCount = 1;
+					command.firstIndex = 0;
+					command.baseVertex = 0;
+					command.baseInstance = (unsigned int)(offset + i);
+				}
+			}, &built, &culled);
+			jobs.wait(built);
+			commandCount = 0;
+			for (size_t i = 0; i < batchCount; i++) {
+				commandCount += visible[i].size();
+			}
+		}
+		double frameMs = elapsedNanoseconds(start) / frames / 1000000.0;
+		if (workerCount == 1) {
+			singleWorkerMs = frameMs;
+		}
+
+		unsigned long long stolen = 0;
+		for (unsigned int i = 0; i < workerCount; i++) {
+			stolen += jobs.getWorkerStats(i).stolen;
+		}
+		std::cout << "  " << workerCount << " workers: " << frameMs << " ms/frame, " << singleWorkerMs / frameMs
+			<< "x, " << commandCount << " commands, " << stolen << " jobs stolen" << std::endl;
+	}
+}
@@ -0,0 +1,70 @@
+/*
+ * Benchmark.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Microbenchmarks run by passing --benchmark on the command line
+ */
+
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <GL/glew.h>
+
+#include <string>
+#include <iostream>
+
+#include "BaseShader.hpp"
+#include "InstancedQuads.hpp"
+#include "SpriteBatch.hpp"
+#include "VertexFormat.hpp"
+#include "IndexBuffer.hpp"
+#include "ObjLoader.hpp"
+#include "MeshLod.hpp"
+#include "FrustumCulling.hpp"
+#include "SceneGraph.hpp"
+#include "UniformBuffer.hpp"
+#include "RenderQueue.hpp"
+#include "JobSystem.hpp"
+
+// Compare setting the textureMix uniform through glGetUniformLocation on every call against the cached table and a handle
+void benchmarkUniformUpdates(BaseShader &shader, int updatesPerFrame, int frames);
+
+// Stream and draw 1000 to maxInstances quads in steps of 10x with one instanced draw per frame, reporting frame time
+void benchmarkInstancedQuads(BaseShader &shader, InstancedQuads &quads, int maxInstances, int frames);
+
+// Queue 10k, 100k and 1M sprites spread over two shaders and two textures, reporting sprites per millisecond
+void benchmarkSpriteBatch(SpriteBatch &batch, BaseShader* shaders[2], const unsigned int textures[2], int frames);
+
+// Draw a gridSide x gridSide vertex mesh from a float layout and a quantized layout, reporting size and vertex throughput
+void benchmarkVertexFormats(BaseShader &shader, int gridSide, int frames);
+
+// Draw a gridSide x gridSide vertex mesh with 32-bit indices, split into 16-bit pieces and as restarted strips
+void benchmarkIndexWidths(BaseShader &shader, int gridSide, int frames);
+
+// Load an OBJ file as it is and optimized, reporting load throughput and cache miss ratios and timing the draws.
+// An empty path writes out a generated sphere to load instead
+void benchmarkObjLoader(BaseShader &shader, const std::string &path, int frames);
+
+// Draw spheres at a range of distances at full detail and then with LOD selection, reporting triangles drawn,
+// frame times and how often levels switch with and without hysteresis. The shader must be the instanced variant
+void benchmarkMeshLod(BaseShader &shader, float viewportHeight, int frames);
+
+// Cull objectCount spheres and as many boxes scattered around a perspective camera with every kernel the CPU has,
+// reporting nanoseconds per object and checking each kernel finds the same visible set
+void benchmarkFrustumCulling(int objectCount, int repeats);
+
+// Animate a nodeCount node hierarchy changing 1% of the local transforms each frame, comparing the dirty update
+// against recomputing every world matrix, then streaming the matrices and drawing a quad per node.
+// The shader must be the instanced world matrix variant
+void benchmarkSceneGraph(BaseShader &shader, int nodeCount, int frames);
+
+// Queue drawCount small quads spread over three shaders, four texture sets and eight vertex arrays in random order,
+// then submit them as queued and sorted by key, reporting state changes per frame and the time to sort and submit
+void benchmarkRenderQueue(BaseShader* shaders[3], const unsigned int textures[2], int drawCount, int frames);
+
+// Move, cull and build indirect commands for objectCount objects on 1 to maxWorkers workers, the commands waiting on
+// the culling through a dependency. Reports frame time, speedup over one worker and how many jobs were stolen
+void benchmarkJobSystem(unsigned int maxWorkers, int objectCount, int frames);
+
+#endif
@@ -0,0 +1,15 @@
+// Shared fragment stage declarations, matching the outputs of SimpleShader.vert
+
+out vec4 FragColor;
+
+in vec3 ourColor;
+in vec2 texCoord;
+
+// Instanced quads carry their own mix and tint instead of reading uniforms
+#ifdef INSTANCED
+flat in float instanceMix;
+flat in vec4 instanceTint;
+#define TINT(color) ((color) * instanceTint)
+#else
+#define TINT(color) (color)
+#endif
\ No newline at end of file
@@ -1,8 +1,6 @@
 #version 330 core
 
-out vec4 FragColor;
-
-in vec3 vertPosition;
+#include "FragCommon.glsl"
 
 void main() {
 	FragColor = vec4(0.357f, 0.188f, 0.906f, 1.0);
@@ -0,0 +1,347 @@
+/*
+ * FrustumCulling.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Bounding spheres and boxes stored as structure of arrays, culled against a frustum four or eight at a time
+ */
+
+#include "FrustumCulling.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CULLING_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+// MSVC lets any function use any intrinsic
+#define TARGET_AVX2
+#else
+// GCC and Clang only allow AVX2 intrinsics in functions compiled for it, the rest of the file stays baseline
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// Extract the planes from a column-major view-projection matrix, as GL stores them, and normalize them
+Frustum Frustum::fromMatrix(const float* m) {
+	// Row r of the matrix is m[r], m[4 + r], m[8 + r], m[12 + r]. Each plane is row 3 plus or minus row 0, 1 or 2
+	Frustum frustum;
+	for (int i = 0; i < 6; i++) {
+		int row = i / 2;
+		float sign = i % 2 == 0 ? 1.0f : -1.0f;
+		Plane &plane = frustum.planes[i];
+		plane.a = m[3] + sign * m[row];
+		plane.b = m[7] + sign * m[4 + row];
+		plane.c = m[11] + sign * m[8 + row];
+		plane.d = m[15] + sign * m[12 + row];
+		float length = std::sqrt(plane.a * plane.a + plane.b * plane.b + plane.c * plane.c);
+		if (length > 0.0f) {
+			plane.a /= length;
+			plane.b /= length;
+			plane.c /= length;
+			plane.d /= length;
+		}
+	}
+	return frustum;
+}
+
+// Volume arrays handed to a kernel. Spheres leave the extents NULL and use radius
+struct VolumeArrays {
+	const float* x;
+	const float* y;
+	const float* z;
+	const float* radius;
+	const float* extentX;
+	const float* extentY;
+	const float* extentZ;
+	const unsigned int* ids;
+	size_t count;
+};
+
+// A sphere is outside when its centre is more than its radius behind any plane. A box is outside when its
+// centre is further behind a plane than the box reaches along that plane's normal
+static size_t cullScalar(const Frustum &frustum, const VolumeArrays &volumes, size_t begin, unsigned int* out) {
+	size_t written = 0;
+	for (size_t i = begin; i < volumes.count; i++) {
+		bool inside = true;
+		for (int p = 0; p < 6 && inside; p++) {
+			const Plane &plane = frustum.planes[p];
+			float distance = plane.a * volumes.x[i] + plane.b * volumes.y[i] + plane.c * volumes.z[i] + plane.d;
+			float reach = volumes.radius != NULL ? volumes.radius[i] : std::fabs(plane.a) * volumes.extentX[i] +
+				std::fabs(plane.b) * volumes.extentY[i] + std::fabs(plane.c) * volumes.extentZ[i];
+			inside = distance + reach > 0.0f;
+		}
+		out[written] = volumes.ids[i];
+		written += inside ? 1 : 0;
+	}
+	return written;
+}
+
+#ifdef CULLING_X86
+
+// Four volumes per instruction, returns the number of volumes covered, leaving the rest for the scalar kernel
+static size_t cullSSE(const Frustum &frustum, const VolumeArrays &volumes, unsigned int* out, size_t &written) {
+	__m128 a[6], b[6], c[6], d[6], absA[6], absB[6], absC[6];
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	for (int p = 0; p < 6; p++) {
+		a[p] = _mm_set1_ps(frustum.planes[p].a);
+		b[p] = _mm_set1_ps(frustum.planes[p].b);
+		c[p] = _mm_set1_ps(frustum.planes[p].c);
+		d[p] = _mm_set1_ps(frustum.planes[p].d);
+		absA[p] = _mm_andnot_ps(signMask, a[p]);
+		absB[p] = _mm_andnot_ps(signMask, b[p]);
+		absC[p] = _mm_andnot_ps(signMask, c[p]);
+	}
+
+	size_t i = 0;
+	for (; i + 4 <= volumes.count; i += 4) {
+		__m128 x = _mm_loadu_ps(volumes.x + i);
+		__m128 y = _mm_loadu_ps(volumes.y + i);
+		__m128 z = _mm_loadu_ps(volumes.z + i);
+		__m128 radius, extentX, extentY, extentZ;
+		if (volumes.radius != NULL) {
+			radius = _mm_loadu_ps(volumes.radius + i);
+		}
+		else {
+			extentX = _mm_loadu_ps(volumes.extentX + i);
+			extentY = _mm_loadu_ps(volumes.extentY + i);
+			extentZ = _mm_loadu_ps(volumes.extentZ + i);
+		}
+
+		int mask = 0xF;
+		for (int p = 0; p < 6 && mask != 0; p++) {
+			__m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a[p], x), _mm_mul_ps(b[p], y)),
+				_mm_add_ps(_mm_mul_ps(c[p], z), d[p]));
+			__m128 reach = volumes.radius != NULL ? radius : _mm_add_ps(_mm_add_ps(_mm_mul_ps(absA[p], extentX),
+				_mm_mul_ps(absB[p], extentY)), _mm_mul_ps(absC[p], extentZ));
+			mask &= _mm_movemask_ps(_mm_cmpgt_ps(_mm_add_ps(distance, reach), _mm_setzero_ps()));
+		}
+
+		// Write every lane and only advance past the visible ones, so there is no branch per volume
+		for (int lane = 0; lane < 4; lane++) {
+			out[written] = volumes.ids[i + lane];
+			written += (mask >> lane) & 1;
+		}
+	}
+	return i;
+}
+
+// Eight volumes per instruction, returns the number of volumes covered, leaving the rest for the scalar kernel
+TARGET_AVX2 static size_t cullAVX2(const Frustum &frustum, const VolumeArrays &volumes, unsigned int* out,
+	size_t &written) {
+	__m256 a[6], b[6], c[6], d[6], absA[6], absB[6], absC[6];
+	const __m256 signMask = _mm256_set1_ps(-0.0f);
+	for (int p = 0; p < 6; p++) {
+		a[p] = _mm256_set1_ps(frustum.planes[p].a);
+		b[p] = _mm256_set1_ps(frustum.planes[p].b);
+		c[p] = _mm256_set1_ps(frustum.planes[p].c);
+		d[p] = _mm256_set1_ps(frustum.planes[p].d);
+		absA[p] = _mm256_andnot_ps(signMask, a[p]);
+		absB[p] = _mm256_andnot_ps(signMask, b[p]);
+		absC[p] = _mm256_andnot_ps(signMask, c[p]);
+	}
+
+	size_t i = 0;
+	for (; i + 8 <= volumes.count; i += 8) {
+		__m256 x = _mm256_loadu_ps(volumes.x + i);
+		__m256 y = _mm256_loadu_ps(volumes.y + i);
+		__m256 z = _mm256_loadu_ps(volumes.z + i);
+		__m256 radius, extentX, extentY, extentZ;
+		if (volumes.radius != NULL) {
+			radius = _mm256_loadu_ps(volumes.radius + i);
+		}
+		else {
+			extentX = _mm256_loadu_ps(volumes.extentX + i);
+			extentY = _mm256_loadu_ps(volumes.extentY + i);
+			extentZ = _mm256_loadu_ps(volumes.extentZ + i);
+		}
+
+		int mask = 0xFF;
+		for (int p = 0; p < 6 && mask != 0; p++) {
+			__m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(a[p], x), _mm256_mul_ps(b[p], y)),
+				_mm256_add_ps(_mm256_mul_ps(c[p], z), d[p]));
+			__m256 reach = volumes.radius != NULL ? radius : _mm256_add_ps(_mm256_add_ps(
+				_mm256_mul_ps(absA[p], extentX), _mm256_mul_ps(absB[p], extentY)), _mm256_mul_ps(absC[p], extentZ));
+			mask &= _mm256_movemask_ps(_mm256_cmp_ps(_mm256_add_ps(distance, reach), _mm256_setzero_ps(), _CMP_GT_OQ));
+		}
+
+		for (int lane = 0; lane < 8; lane++) {
+			out[written] = volumes.ids[i + lane];
+			written += (mask >> lane) & 1;
+		}
+	}
+	return i;
+}
+
+#endif
+
+// Run the chosen kernel over one kind of volume, with the scalar kernel finishing what it leaves
+static void cullVolumes(FrustumCuller::Path path, const Frustum &frustum, const VolumeArrays &volumes,
+	std::vector<unsigned int> &visible) {
+	if (volumes.count == 0) {
+		return;
+	}
+	// Room for every volume up front, the kernels write through a pointer and the unused tail is dropped after
+	size_t start = visible.size();
+	visible.resize(start + volumes.count);
+	unsigned int* out = &visible[start];
+	size_t written = 0;
+	size_t covered = 0;
+#ifdef CULLING_X86
+	if (path == FrustumCuller::AVX2) {
+		covered = cullAVX2(frustum, volumes, out, written);
+	}
+	else if (path == FrustumCuller::SSE) {
+		covered = cullSSE(frustum, volumes, out, written);
+	}
+#endif
+	written += cullScalar(frustum, volumes, covered, out + written);
+	visible.resize(start + written);
+}
+
+// Widest kernel this CPU and operating system support
+FrustumCuller::Path FrustumCuller::detectPath() {
+#ifdef CULLING_X86
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] >= 7) {
+		__cpuid(info, 1);
+		bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+		__cpuidex(info, 7, 0);
+		bool avx2 = (info[1] & (1 << 5)) != 0;
+		// The OS has to save the upper halves of the registers on a context switch too
+		if (avx2 && osSavesYmm && (_xgetbv(0) & 6) == 6) {
+			return AVX2;
+		}
+	}
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		return AVX2;
+	}
+#endif
+	// Every x86-64 CPU has SSE, and this project does not target 32 bit CPUs older than it
+	return SSE;
+#else
+	return SCALAR;
+#endif
+}
+
+// Name of a kernel for reports
+const char* FrustumCuller::pathName(Path path) {
+	switch (path) {
+	case AVX2:
+		return "AVX2";
+	case SSE:
+		return "SSE";
+	default:
+		return "scalar";
+	}
+}
+
+// Constructor starts empty, using the widest kernel available
+FrustumCuller::FrustumCuller() : path(detectPath()) {
+}
+
+// Remove every volume
+void FrustumCuller::clear() {
+	sphereX.clear();
+	sphereY.clear();
+	sphereZ.clear();
+	sphereRadius.clear();
+	sphereIds.clear();
+	boxX.clear();
+	boxY.clear();
+	boxZ.clear();
+	boxExtentX.clear();
+	boxExtentY.clear();
+	boxExtentZ.clear();
+	boxIds.clear();
+}
+
+// Add a bounding sphere or an axis aligned box given by its centre and half extents, for the object id.
+// Returns the slot to move the volume with later
+size_t FrustumCuller::addSphere(unsigned int id, float x, float y, float z, float radius) {
+	sphereX.push_back(x);
+	sphereY.push_back(y);
+	sphereZ.push_back(z);
+	sphereRadius.push_back(radius);
+	sphereIds.push_back(id);
+	return sphereIds.size() - 1;
+}
+
+size_t FrustumCuller::addBox(unsigned int id, float x, float y, float z, float extentX, float extentY, float extentZ) {
+	boxX.push_back(x);
+	boxY.push_back(y);
+	boxZ.push_back(z);
+	boxExtentX.push_back(extentX);
+	boxExtentY.push_back(extentY);
+	boxExtentZ.push_back(extentZ);
+	boxIds.push_back(id);
+	return boxIds.size() - 1;
+}
+
+// Move a volume added earlier
+void FrustumCuller::setSphere(size_t slot, float x, float y, float z, float radius) {
+	sphereX[slot] = x;
+	sphereY[slot] = y;
+	sphereZ[slot] = z;
+	sphereRadius[slot] = radius;
+}
+
+void FrustumCuller::setBox(size_t slot, float x, float y, float z, float extentX, float extentY, float extentZ) {
+	boxX[slot] = x;
+	boxY[slot] = y;
+	boxZ[slot] = z;
+	boxExtentX[slot] = extentX;
+	boxExtentY[slot] = extentY;
+	boxExtentZ[slot] = extentZ;
+}
+
+// Force a kernel, asking for one the CPU lacks gets the widest it has instead
+void FrustumCuller::setPath(Path requested) {
+	Path widest = detectPath();
+	path = requested > widest ? widest : requested;
+}
+
+FrustumCuller::Path FrustumCuller::getPath() const {
+	return path;
+}
+
+// Append the ids of every volume at least partly inside the frustum, spheres before boxes, and return how many
+size_t FrustumCuller::cull(const Frustum &frustum, std::vector<unsigned int> &visible) const {
+	return cull(frustum, visible, 0, sphereIds.size() + boxIds.size());
+}
+
+// Cull only the volumes from begin up to end, counting the spheres and then the boxes, so separate ranges
+// can be culled as separate jobs
+size_t FrustumCuller::cull(const Frustum &frustum, std::vector<unsigned int> &visible, size_t begin, size_t end) const {
+	size_t before = visible.size();
+	size_t sphereCount = sphereIds.size();
+	size_t sphereBegin = std::min(begin, sphereCount), sphereEnd = std::min(end, sphereCount);
+	if (sphereBegin < sphereEnd) {
+		VolumeArrays spheres = { &sphereX[sphereBegin], &sphereY[sphereBegin], &sphereZ[sphereBegin],
+			&sphereRadius[sphereBegin], NULL, NULL, NULL, &sphereIds[sphereBegin], sphereEnd - sphereBegin };
+		cullVolumes(path, frustum, spheres, visible);
+	}
+	size_t boxBegin = std::min(std::max(begin, sphereCount) - sphereCount, boxIds.size());
+	size_t boxEnd = std::min(std::max(end, sphereCount) - sphereCount, boxIds.size());
+	if (boxBegin < boxEnd) {
+		VolumeArrays boxes = { &boxX[boxBegin], &boxY[boxBegin], &boxZ[boxBegin], NULL, &boxExtentX[boxBegin],
+			&boxExtentY[boxBegin], &boxExtentZ[boxBegin], &boxIds[boxBegin], boxEnd - boxBegin };
+		cullVolumes(path, frustum, boxes, visible);
+	}
+	return visible.size() - before;
+}
+
+// Number of volumes of each kind
+size_t FrustumCuller::getSphereCount() const {
+	return sphereIds.size();
+}
+
+size_t FrustumCuller::getBoxCount() const {
+	return boxIds.size();
+}
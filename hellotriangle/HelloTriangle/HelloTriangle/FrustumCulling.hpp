@@ -0,0 +1,77 @@
+/*
+ * FrustumCulling.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Bounding spheres and boxes stored as structure of arrays, culled against a frustum four or eight at a time
+ */
+
+#ifndef FRUSTUMCULLING_HPP
+#define FRUSTUMCULLING_HPP
+
+#include <vector>
+#include <cstddef>
+
+// Plane x * a + y * b + z * c + d = 0, with the normal pointing into the frustum
+struct Plane {
+	float a, b, c, d;
+};
+
+// Left, right, bottom, top, near and far planes of a view frustum
+struct Frustum {
+	Plane planes[6];
+
+	// Extract the planes from a column-major view-projection matrix, as GL stores them, and normalize them
+	static Frustum fromMatrix(const float* viewProjection);
+};
+
+class FrustumCuller {
+public:
+	// Kernels, each processing one, four or eight volumes per instruction
+	enum Path { SCALAR, SSE, AVX2 };
+
+	// Widest kernel this CPU and operating system support
+	static Path detectPath();
+
+	// Name of a kernel for reports
+	static const char* pathName(Path path);
+
+	// Constructor starts empty, using the widest kernel available
+	FrustumCuller();
+
+	// Remove every volume
+	void clear();
+
+	// Add a bounding sphere or an axis aligned box given by its centre and half extents, for the object id.
+	// Returns the slot to move the volume with later
+	size_t addSphere(unsigned int id, float x, float y, float z, float radius);
+	size_t addBox(unsigned int id, float x, float y, float z, float extentX, float extentY, float extentZ);
+
+	// Move a volume added earlier
+	void setSphere(size_t slot, float x, float y, float z, float radius);
+	void setBox(size_t slot, float x, float y, float z, float extentX, float extentY, float extentZ);
+
+	// Force a kernel, asking for one the CPU lacks gets the widest it has instead
+	void setPath(Path requested);
+	Path getPath() const;
+
+	// Append the ids of every volume at least partly inside the frustum, spheres before boxes, and return how many
+	size_t cull(const Frustum &frustum, std::vector<unsigned int> &visible) const;
+
+	// Cull only the volumes from begin up to end, counting the spheres and then the boxes, so separate ranges
+	// can be culled as separate jobs
+	size_t cull(const Frustum &frustum, std::vector<unsigned int> &visible, size_t begin, size_t end) const;
+
+	// Number of volumes of each kind
+	size_t getSphereCount() const;
+	size_t getBoxCount() const;
+
+private:
+	std::vector<float> sphereX, sphereY, sphereZ, sphereRadius;
+	std::vector<unsigned int> sphereIds;
+	std::vector<float> boxX, boxY, boxZ, boxExtentX, boxExtentY, boxExtentZ;
+	std::vector<unsigned int> boxIds;
+	Path path;
+};
+
+#endif
@@ -0,0 +1,355 @@
+/*
+ * GLState.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Shadow copy of the GL binding and fixed-function state that drops redundant calls
+ */
+
+#include "GLState.hpp"
+
+// Value held by the cache for state it has not seen set, never equal to a real name or enum
+static const unsigned int UNKNOWN = 0xFFFFFFFFu;
+
+// Units and indexed bindings beyond these are passed straight through
+static const int MAX_TEXTURE_UNITS = 32;
+static const int MAX_UNIFORM_BINDINGS = 72;
+
+static const GLenum TEXTURE_TARGETS[] = {
+	GL_TEXTURE_2D, GL_TEXTURE_3D, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BUFFER
+};
+static const GLenum BUFFER_TARGETS[] = {
+	GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+	GL_PIXEL_PACK_BUFFER, GL_PIXEL_UNPACK_BUFFER, GL_TEXTURE_BUFFER, GL_DRAW_INDIRECT_BUFFER
+};
+static const GLenum CAPABILITIES[] = {
+	GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_SCISSOR_TEST, GL_PRIMITIVE_RESTART
+};
+
+static const int TEXTURE_TARGET_COUNT = sizeof(TEXTURE_TARGETS) / sizeof(TEXTURE_TARGETS[0]);
+static const int BUFFER_TARGET_COUNT = sizeof(BUFFER_TARGETS) / sizeof(BUFFER_TARGETS[0]);
+static const int CAPABILITY_COUNT = sizeof(CAPABILITIES) / sizeof(CAPABILITIES[0]);
+
+// Indexed uniform buffer binding
+struct RangeBinding {
+	unsigned int buffer;
+	GLintptr offset;
+	GLsizeiptr size;
+};
+
+// Everything the cache believes the context currently holds
+struct CachedState {
+	unsigned int program;
+	unsigned int pipeline;
+	unsigned int vertexArray;
+	unsigned int activeUnit;
+	unsigned int textures[MAX_TEXTURE_UNITS][TEXTURE_TARGET_COUNT];
+	unsigned int buffers[BUFFER_TARGET_COUNT];
+	RangeBinding uniformBindings[MAX_UNIFORM_BINDINGS];
+	unsigned int capabilities[CAPABILITY_COUNT];
+	unsigned int restartIndex;
+	bool restartIndexKnown;
+	unsigned int blendSource, blendDestination;
+	unsigned int depthFunction, depthWrite;
+	int viewport[4];
+	bool viewportKnown;
+
+	// Constructor starts with nothing known
+	CachedState() {
+		reset();
+	}
+
+	// Mark every piece of state unknown
+	void reset() {
+		program = UNKNOWN;
+		pipeline = UNKNOWN;
+		vertexArray = UNKNOWN;
+		activeUnit = UNKNOWN;
+		for (int unit = 0; unit < MAX_TEXTURE_UNITS; unit++) {
+			for (int target = 0; target < TEXTURE_TARGET_COUNT; target++) {
+				textures[unit][target] = UNKNOWN;
+			}
+		}
+		for (int target = 0; target < BUFFER_TARGET_COUNT; target++) {
+			buffers[target] = UNKNOWN;
+		}
+		for (int index = 0; index < MAX_UNIFORM_BINDINGS; index++) {
+			uniformBindings[index].buffer = UNKNOWN;
+		}
+		for (int capability = 0; capability < CAPABILITY_COUNT; capability++) {
+			capabilities[capability] = UNKNOWN;
+		}
+		restartIndexKnown = false;
+		blendSource = blendDestination = UNKNOWN;
+		depthFunction = depthWrite = UNKNOWN;
+		viewportKnown = false;
+	}
+};
+
+static CachedState state;
+
+GLStateStats GLState::frameStats = { 0, 0, 0, 0, 0 };
+
+// Helper function to find the slot for an enum in one of the tables, -1 if it is not tracked
+static int findEnum(const GLenum* table, int count, GLenum value) {
+	for (int i = 0; i < count; i++) {
+		if (table[i] == value) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+// Make a program current
+void GLState::useProgram(unsigned int program) {
+	if (state.program == program) {
+		frameStats.elided++;
+		return;
+	}
+	glUseProgram(program);
+	state.program = program;
+	frameStats.issued++;
+	frameStats.programChanges++;
+}
+
+// Current program, asking the driver only if the cache does not know it
+unsigned int GLState::currentProgram() {
+	if (state.program == UNKNOWN) {
+		int program = 0;
+		glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+		state.program = (unsigned int)program;
+	}
+	return state.program;
+}
+
+// Bind a program pipeline, which is only used for drawing while no program is current
+void GLState::bindProgramPipeline(unsigned int pipeline) {
+	if (state.pipeline == pipeline) {
+		frameStats.elided++;
+		return;
+	}
+	glBindProgramPipeline(pipeline);
+	state.pipeline = pipeline;
+	frameStats.issued++;
+}
+
+// Bind a vertex array, which also brings in its element array buffer
+void GLState::bindVertexArray(unsigned int vertexArray) {
+	if (state.vertexArray == vertexArray) {
+		frameStats.elided++;
+		return;
+	}
+	glBindVertexArray(vertexArray);
+	state.vertexArray = vertexArray;
+	// The element array binding belongs to the vertex array, so it is whatever that array last recorded
+	state.buffers[findEnum(BUFFER_TARGETS, BUFFER_TARGET_COUNT, GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+	frameStats.issued++;
+	frameStats.vertexArrayChanges++;
+}
+
+// Select a texture unit by index, not by GL_TEXTURE0 + index
+void GLState::activeTexture(unsigned int unit) {
+	if (state.activeUnit == unit) {
+		frameStats.elided++;
+		return;
+	}
+	glActiveTexture(GL_TEXTURE0 + unit);
+	state.activeUnit = unit;
+	frameStats.issued++;
+}
+
+// Bind a texture to a unit, only switching the active unit if the binding has to change
+void GLState::bindTexture(unsigned int unit, GLenum target, unsigned int texture) {
+	int slot = findEnum(TEXTURE_TARGETS, TEXTURE_TARGET_COUNT, target);
+	if (slot != -1 && unit < (unsigned int)MAX_TEXTURE_UNITS && state.textures[unit][slot] == texture) {
+		frameStats.elided++;
+		return;
+	}
+	activeTexture(unit);
+	glBindTexture(target, texture);
+	if (slot != -1 && unit < (unsigned int)MAX_TEXTURE_UNITS) {
+		state.textures[unit][slot] = texture;
+	}
+	frameStats.issued++;
+	frameStats.textureChanges++;
+}
+
+// Bind a buffer to a non-indexed target
+void GLState::bindBuffer(GLenum target, unsigned int buffer) {
+	int slot = findEnum(BUFFER_TARGETS, BUFFER_TARGET_COUNT, target);
+	if (slot != -1 && state.buffers[slot] == buffer) {
+		frameStats.elided++;
+		return;
+	}
+	glBindBuffer(target, buffer);
+	if (slot != -1) {
+		state.buffers[slot] = buffer;
+	}
+	frameStats.issued++;
+}
+
+// Bind a buffer range to an indexed target such as GL_UNIFORM_BUFFER
+void GLState::bindBufferRange(GLenum target, unsigned int index, unsigned int buffer, GLintptr offset, GLsizeiptr size) {
+	bool tracked = target == GL_UNIFORM_BUFFER && index < (unsigned int)MAX_UNIFORM_BINDINGS;
+	if (tracked) {
+		const RangeBinding &binding = state.uniformBindings[index];
+		if (binding.buffer == buffer && binding.offset == offset && binding.size == size) {
+			frameStats.elided++;
+			return;
+		}
+	}
+	glBindBufferRange(target, index, buffer, offset, size);
+	if (tracked) {
+		state.uniformBindings[index].buffer = buffer;
+		state.uniformBindings[index].offset = offset;
+		state.uniformBindings[index].size = size;
+	}
+	// An indexed bind also replaces the generic binding for the target
+	int slot = findEnum(BUFFER_TARGETS, BUFFER_TARGET_COUNT, target);
+	if (slot != -1) {
+		state.buffers[slot] = buffer;
+	}
+	frameStats.issued++;
+}
+
+// glEnable or glDisable a capability such as GL_BLEND or GL_DEPTH_TEST
+void GLState::setEnabled(GLenum capability, bool enabled) {
+	int slot = findEnum(CAPABILITIES, CAPABILITY_COUNT, capability);
+	if (slot != -1 && state.capabilities[slot] == (unsigned int)enabled) {
+		frameStats.elided++;
+		return;
+	}
+	if (enabled) {
+		glEnable(capability);
+	}
+	else {
+		glDisable(capability);
+	}
+	if (slot != -1) {
+		state.capabilities[slot] = (unsigned int)enabled;
+	}
+	frameStats.issued++;
+}
+
+// Index value that ends a strip while GL_PRIMITIVE_RESTART is enabled
+void GLState::primitiveRestartIndex(unsigned int index) {
+	// 0xFFFFFFFF is a valid restart index, so it needs its own known flag rather than UNKNOWN
+	if (state.restartIndexKnown && state.restartIndex == index) {
+		frameStats.elided++;
+		return;
+	}
+	glPrimitiveRestartIndex(index);
+	state.restartIndex = index;
+	state.restartIndexKnown = true;
+	frameStats.issued++;
+}
+
+// Blend factors for both color and alpha
+void GLState::blendFunc(GLenum source, GLenum destination) {
+	if (state.blendSource == source && state.blendDestination == destination) {
+		frameStats.elided++;
+		return;
+	}
+	glBlendFunc(source, destination);
+	state.blendSource = source;
+	state.blendDestination = destination;
+	frameStats.issued++;
+}
+
+// Depth comparison and whether depth is written
+void GLState::depthFunc(GLenum function) {
+	if (state.depthFunction == function) {
+		frameStats.elided++;
+		return;
+	}
+	glDepthFunc(function);
+	state.depthFunction = function;
+	frameStats.issued++;
+}
+
+void GLState::depthMask(bool write) {
+	if (state.depthWrite == (unsigned int)write) {
+		frameStats.elided++;
+		return;
+	}
+	glDepthMask(write ? GL_TRUE : GL_FALSE);
+	state.depthWrite = (unsigned int)write;
+	frameStats.issued++;
+}
+
+// Viewport rectangle
+void GLState::viewport(int x, int y, int width, int height) {
+	if (state.viewportKnown && state.viewport[0] == x && state.viewport[1] == y
+		&& state.viewport[2] == width && state.viewport[3] == height) {
+		frameStats.elided++;
+		return;
+	}
+	glViewport(x, y, width, height);
+	state.viewport[0] = x;
+	state.viewport[1] = y;
+	state.viewport[2] = width;
+	state.viewport[3] = height;
+	state.viewportKnown = true;
+	frameStats.issued++;
+}
+
+// Delete objects, clearing any binding the cache holds for them so a reused name is not mistaken for them
+void GLState::deleteBuffer(unsigned int buffer) {
+	glDeleteBuffers(1, &buffer);
+	// GL unbinds a deleted buffer from every binding point of the current context
+	for (int target = 0; target < BUFFER_TARGET_COUNT; target++) {
+		if (state.buffers[target] == buffer) {
+			state.buffers[target] = 0;
+		}
+	}
+	for (int index = 0; index < MAX_UNIFORM_BINDINGS; index++) {
+		if (state.uniformBindings[index].buffer == buffer) {
+			state.uniformBindings[index].buffer = UNKNOWN;
+		}
+	}
+}
+
+void GLState::deleteTexture(unsigned int texture) {
+	glDeleteTextures(1, &texture);
+	for (int unit = 0; unit < MAX_TEXTURE_UNITS; unit++) {
+		for (int target = 0; target < TEXTURE_TARGET_COUNT; target++) {
+			if (state.textures[unit][target] == texture) {
+				state.textures[unit][target] = 0;
+			}
+		}
+	}
+}
+
+void GLState::deleteVertexArray(unsigned int vertexArray) {
+	glDeleteVertexArrays(1, &vertexArray);
+	if (state.vertexArray == vertexArray) {
+		state.vertexArray = 0;
+		state.buffers[findEnum(BUFFER_TARGETS, BUFFER_TARGET_COUNT, GL_ELEMENT_ARRAY_BUFFER)] = 0;
+	}
+}
+
+void GLState::deleteProgramPipeline(unsigned int pipeline) {
+	glDeleteProgramPipelines(1, &pipeline);
+	if (state.pipeline == pipeline) {
+		state.pipeline = 0;
+	}
+}
+
+// Forget everything, so the next call of each kind reaches the driver
+void GLState::invalidate() {
+	state.reset();
+}
+
+// Calls issued and elided since the last reset
+GLStateStats GLState::getFrameStats() {
+	return frameStats;
+}
+
+// Called at the start of a frame to restart the counts
+void GLState::resetFrameStats() {
+	frameStats.issued = 0;
+	frameStats.elided = 0;
+	frameStats.programChanges = 0;
+	frameStats.textureChanges = 0;
+	frameStats.vertexArrayChanges = 0;
+}
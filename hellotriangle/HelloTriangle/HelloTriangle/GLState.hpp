@@ -0,0 +1,87 @@
+/*
+ * GLState.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Shadow copy of the GL binding and fixed-function state that drops redundant calls
+ */
+
+#ifndef GLSTATE_HPP
+#define GLSTATE_HPP
+
+#include <GL/glew.h>
+
+// Number of state calls sent to the driver and dropped because GL already had that state, with the
+// issued program, texture and vertex array binds also counted on their own as the most expensive switches
+struct GLStateStats {
+	unsigned int issued;
+	unsigned int elided;
+	unsigned int programChanges;
+	unsigned int textureChanges;
+	unsigned int vertexArrayChanges;
+};
+
+// All state changes for the context go through here so the cache matches the driver,
+// anything done with raw GL calls must be followed by invalidate()
+class GLState {
+public:
+	// Make a program current
+	static void useProgram(unsigned int program);
+
+	// Current program, asking the driver only if the cache does not know it
+	static unsigned int currentProgram();
+
+	// Bind a program pipeline, which is only used for drawing while no program is current
+	static void bindProgramPipeline(unsigned int pipeline);
+
+	// Bind a vertex array, which also brings in its element array buffer
+	static void bindVertexArray(unsigned int vertexArray);
+
+	// Select a texture unit by index, not by GL_TEXTURE0 + index
+	static void activeTexture(unsigned int unit);
+
+	// Bind a texture to a unit, only switching the active unit if the binding has to change
+	static void bindTexture(unsigned int unit, GLenum target, unsigned int texture);
+
+	// Bind a buffer to a non-indexed target
+	static void bindBuffer(GLenum target, unsigned int buffer);
+
+	// Bind a buffer range to an indexed target such as GL_UNIFORM_BUFFER
+	static void bindBufferRange(GLenum target, unsigned int index, unsigned int buffer, GLintptr offset, GLsizeiptr size);
+
+	// glEnable or glDisable a capability such as GL_BLEND or GL_DEPTH_TEST
+	static void setEnabled(GLenum capability, bool enabled);
+
+	// Index value that ends a strip while GL_PRIMITIVE_RESTART is enabled
+	static void primitiveRestartIndex(unsigned int index);
+
+	// Blend factors for both color and alpha
+	static void blendFunc(GLenum source, GLenum destination);
+
+	// Depth comparison and whether depth is written
+	static void depthFunc(GLenum function);
+	static void depthMask(bool write);
+
+	// Viewport rectangle
+	static void viewport(int x, int y, int width, int height);
+
+	// Delete objects, clearing any binding the cache holds for them so a reused name is not mistaken for them
+	static void deleteBuffer(unsigned int buffer);
+	static void deleteTexture(unsigned int texture);
+	static void deleteVertexArray(unsigned int vertexArray);
+	static void deleteProgramPipeline(unsigned int pipeline);
+
+	// Forget everything, so the next call of each kind reaches the driver
+	static void invalidate();
+
+	// Calls issued and elided since the last reset
+	static GLStateStats getFrameStats();
+
+	// Called at the start of a frame to restart the counts
+	static void resetFrameStats();
+
+private:
+	static GLStateStats frameStats;
+};
+
+#endif
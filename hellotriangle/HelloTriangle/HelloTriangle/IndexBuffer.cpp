@@ -0,0 +1,254 @@
+/*
+ * IndexBuffer.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Element buffers stored at the narrowest index type, split into 16-bit pieces or drawn as restarted strips
+ */
+
+#include "IndexBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+const unsigned int IndexBuffer::RESTART;
+
+// Narrowest of GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT and GL_UNSIGNED_INT that can address vertexCount
+// vertices, keeping the largest value free for the restart index when strips use it
+GLenum IndexBuffer::chooseType(size_t vertexCount, bool restart) {
+	size_t reserved = restart ? 1 : 0;
+	if (vertexCount <= 0x100 - reserved) {
+		return GL_UNSIGNED_BYTE;
+	}
+	if (vertexCount <= 0x10000 - reserved) {
+		return GL_UNSIGNED_SHORT;
+	}
+	return GL_UNSIGNED_INT;
+}
+
+// Bytes per index, and the largest value of the type which is used as its restart index
+size_t IndexBuffer::typeSize(GLenum type) {
+	switch (type) {
+	case GL_UNSIGNED_BYTE: return 1;
+	case GL_UNSIGNED_SHORT: return 2;
+	default: return 4;
+	}
+}
+
+unsigned int IndexBuffer::restartIndex(GLenum type) {
+	switch (type) {
+	case GL_UNSIGNED_BYTE: return 0xFFu;
+	case GL_UNSIGNED_SHORT: return 0xFFFFu;
+	default: return 0xFFFFFFFFu;
+	}
+}
+
+// Split a triangle list into pieces that each reference at most maxVertices distinct vertices.
+// Output vertex i is source vertex remap[i], and each piece's indices are relative to its base vertex
+void IndexBuffer::split(const std::vector<unsigned int> &indices, size_t maxVertices,
+	std::vector<unsigned int> &localIndices, std::vector<unsigned int> &remap, std::vector<IndexRange> &ranges) {
+	localIndices.clear();
+	remap.clear();
+	ranges.clear();
+	if (indices.empty() || maxVertices < 3) {
+		return;
+	}
+	unsigned int sourceVertices = *std::max_element(indices.begin(), indices.end()) + 1;
+
+	// Piece that last gave each source vertex a local index, and that index
+	std::vector<int> owner(sourceVertices, -1);
+	std::vector<unsigned int> local(sourceVertices);
+	int piece = 0;
+	size_t pieceStart = 0;
+	size_t pieceFirstIndex = 0;
+	localIndices.reserve(indices.size());
+
+	for (size_t triangle = 0; triangle + 2 < indices.size(); triangle += 3) {
+		size_t added = 0;
+		for (int corner = 0; corner < 3; corner++) {
+			if (owner[indices[triangle + corner]] != piece) {
+				added++;
+			}
+		}
+		// Start a new piece when this triangle's vertices would not fit, vertices it shares with the
+		// previous piece are repeated in the new one
+		if (remap.size() - pieceStart + added > maxVertices) {
+			IndexRange range = { (unsigned int)(localIndices.size() - pieceFirstIndex), (unsigned int)pieceFirstIndex, (int)pieceStart };
+			ranges.push_back(range);
+			piece++;
+			pieceStart = remap.size();
+			pieceFirstIndex = localIndices.size();
+		}
+		for (int corner = 0; corner < 3; corner++) {
+			unsigned int vertex = indices[triangle + corner];
+			if (owner[vertex] != piece) {
+				owner[vertex] = piece;
+				local[vertex] = (unsigned int)(remap.size() - pieceStart);
+				remap.push_back(vertex);
+			}
+			localIndices.push_back(local[vertex]);
+		}
+	}
+	if (localIndices.size() > pieceFirstIndex) {
+		IndexRange range = { (unsigned int)(localIndices.size() - pieceFirstIndex), (unsigned int)pieceFirstIndex, (int)pieceStart };
+		ranges.push_back(range);
+	}
+}
+
+// Reorder interleaved vertex data by a remap from split
+void IndexBuffer::remapVertices(const unsigned char* vertices, size_t stride, const std::vector<unsigned int> &remap,
+	std::vector<unsigned char> &output) {
+	output.resize(remap.size() * stride);
+	for (size_t i = 0; i < remap.size(); i++) {
+		std::memcpy(output.data() + i * stride, vertices + (size_t)remap[i] * stride, stride);
+	}
+}
+
+// Constructor creates the element buffer, it is empty until one of the uploads
+IndexBuffer::IndexBuffer() : vertexArray(0), type(GL_UNSIGNED_INT), mode(GL_TRIANGLES), restart(false), byteSize(0) {
+	glGenBuffers(1, &buffer);
+}
+
+// Destructor releases the element buffer
+IndexBuffer::~IndexBuffer() {
+	GLState::deleteBuffer(buffer);
+}
+
+// Upload indices into a vertex array at the narrowest type. Strips and fans may contain RESTART
+void IndexBuffer::upload(unsigned int vertexArray, const std::vector<unsigned int> &indices, size_t vertexCount, GLenum mode) {
+	for (size_t i = 0; i < indices.size(); i++) {
+		if (indices[i] != RESTART && indices[i] >= vertexCount) {
+			std::cout << "Error: index " << indices[i] << " is past the end of " << vertexCount << " vertices" << std::endl;
+			return;
+		}
+	}
+	this->mode = mode;
+	restart = std::find(indices.begin(), indices.end(), RESTART) != indices.end();
+	type = chooseType(vertexCount, restart);
+	store(vertexArray, indices);
+
+	IndexRange whole = { (unsigned int)indices.size(), 0, 0 };
+	setRanges(std::vector<IndexRange>(1, whole));
+}
+
+// Upload a triangle list with more vertices than 16-bit indices address, splitting it into 16-bit pieces when
+// the index bytes saved outweigh the vertices duplicated along the seams. remap is left empty if it is not split,
+// otherwise the vertex buffer has to be rebuilt with remapVertices
+void IndexBuffer::uploadTriangles(unsigned int vertexArray, const std::vector<unsigned int> &indices, size_t vertexCount,
+	size_t vertexStride, std::vector<unsigned int> &remap) {
+	remap.clear();
+	if (chooseType(vertexCount) != GL_UNSIGNED_INT) {
+		upload(vertexArray, indices, vertexCount, GL_TRIANGLES);
+		return;
+	}
+
+	std::vector<unsigned int> localIndices;
+	std::vector<unsigned int> splitRemap;
+	std::vector<IndexRange> pieces;
+	split(indices, 0x10000, localIndices, splitRemap, pieces);
+
+	// Every index shrinks by two bytes, every vertex repeated in a second piece costs a whole vertex
+	size_t savedBytes = indices.size() * 2;
+	size_t duplicatedBytes = splitRemap.size() > vertexCount ? (splitRemap.size() - vertexCount) * vertexStride : 0;
+	if (duplicatedBytes >= savedBytes) {
+		upload(vertexArray, indices, vertexCount, GL_TRIANGLES);
+		return;
+	}
+
+	mode = GL_TRIANGLES;
+	restart = false;
+	type = GL_UNSIGNED_SHORT;
+	store(vertexArray, localIndices);
+	setRanges(pieces);
+	remap.swap(splitRemap);
+}
+
+// Bind the vertex array and draw every piece, a split mesh going out with one glMultiDrawElementsBaseVertex
+void IndexBuffer::draw() const {
+	if (counts.empty()) {
+		return;
+	}
+	GLState::bindVertexArray(vertexArray);
+	// Restart is switched off for meshes without it, where the largest index is an ordinary vertex
+	GLState::setEnabled(GL_PRIMITIVE_RESTART, restart);
+	if (restart) {
+		GLState::primitiveRestartIndex(restartIndex(type));
+	}
+	if (counts.size() == 1 && baseVertices[0] == 0) {
+		glDrawElements(mode, counts[0], type, offsets[0]);
+	}
+	else {
+		glMultiDrawElementsBaseVertex(mode, counts.data(), type, offsets.data(), (GLsizei)counts.size(), baseVertices.data());
+	}
+}
+
+// Draw count indices from firstIndex of a buffer uploaded in one piece, such as one level of several stored together
+void IndexBuffer::drawRange(unsigned int firstIndex, unsigned int count) const {
+	if (ranges.size() != 1) {
+		std::cout << "Error: a range can only be drawn from an index buffer uploaded in one piece" << std::endl;
+		return;
+	}
+	GLState::bindVertexArray(vertexArray);
+	GLState::setEnabled(GL_PRIMITIVE_RESTART, restart);
+	if (restart) {
+		GLState::primitiveRestartIndex(restartIndex(type));
+	}
+	glDrawElements(mode, (GLsizei)count, type, (const void*)(firstIndex * typeSize(type)));
+}
+
+// Index type, bytes in the element buffer and the pieces drawn
+GLenum IndexBuffer::getType() const {
+	return type;
+}
+
+unsigned int IndexBuffer::getBuffer() const {
+	return buffer;
+}
+
+size_t IndexBuffer::getByteSize() const {
+	return byteSize;
+}
+
+const std::vector<IndexRange> &IndexBuffer::getRanges() const {
+	return ranges;
+}
+
+// Helper function to narrow indices to the chosen type and store them in the vertex array's element buffer
+void IndexBuffer::store(unsigned int targetArray, const std::vector<unsigned int> &indices) {
+	size_t size = typeSize(type);
+	unsigned int restartValue = restartIndex(type);
+	std::vector<unsigned char> data(indices.size() * size);
+	for (size_t i = 0; i < indices.size(); i++) {
+		unsigned int value = indices[i] == RESTART ? restartValue : indices[i];
+		if (size == 1) {
+			data[i] = (unsigned char)value;
+		}
+		else if (size == 2) {
+			unsigned short narrow = (unsigned short)value;
+			std::memcpy(data.data() + i * 2, &narrow, 2);
+		}
+		else {
+			std::memcpy(data.data() + i * 4, &value, 4);
+		}
+	}
+
+	// The element array binding is recorded in the vertex array, so it has to be bound first
+	vertexArray = targetArray;
+	GLState::bindVertexArray(vertexArray);
+	GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, data.size(), data.data(), GL_STATIC_DRAW);
+	byteSize = data.size();
+}
+
+// Helper function to rebuild the multi-draw arguments from the ranges
+void IndexBuffer::setRanges(const std::vector<IndexRange> &newRanges) {
+	ranges = newRanges;
+	counts.clear();
+	offsets.clear();
+	baseVertices.clear();
+	for (size_t i = 0; i < ranges.size(); i++) {
+		counts.push_back((GLsizei)ranges[i].count);
+		offsets.push_back((const void*)(ranges[i].firstIndex * typeSize(type)));
+		baseVertices.push_back(ranges[i].baseVertex);
+	}
+}
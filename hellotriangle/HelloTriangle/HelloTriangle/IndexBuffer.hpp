@@ -0,0 +1,100 @@
+/*
+ * IndexBuffer.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Element buffers stored at the narrowest index type, split into 16-bit pieces or drawn as restarted strips
+ */
+
+#ifndef INDEXBUFFER_HPP
+#define INDEXBUFFER_HPP
+
+#include <GL/glew.h>
+
+#include <vector>
+#include <iostream>
+
+#include "GLState.hpp"
+
+// One piece of a mesh: count indices from firstIndex, reading vertices from baseVertex on
+struct IndexRange {
+	unsigned int count;
+	unsigned int firstIndex;
+	int baseVertex;
+};
+
+class IndexBuffer {
+public:
+	// Source index that ends a strip, converted to the restart value of whichever type is chosen
+	static const unsigned int RESTART = 0xFFFFFFFFu;
+
+	// Narrowest of GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT and GL_UNSIGNED_INT that can address vertexCount
+	// vertices, keeping the largest value free for the restart index when strips use it
+	static GLenum chooseType(size_t vertexCount, bool restart = false);
+
+	// Bytes per index, and the largest value of the type which is used as its restart index
+	static size_t typeSize(GLenum type);
+	static unsigned int restartIndex(GLenum type);
+
+	// Split a triangle list into pieces that each reference at most maxVertices distinct vertices.
+	// Output vertex i is source vertex remap[i], and each piece's indices are relative to its base vertex
+	static void split(const std::vector<unsigned int> &indices, size_t maxVertices,
+		std::vector<unsigned int> &localIndices, std::vector<unsigned int> &remap, std::vector<IndexRange> &ranges);
+
+	// Reorder interleaved vertex data by a remap from split
+	static void remapVertices(const unsigned char* vertices, size_t stride, const std::vector<unsigned int> &remap,
+		std::vector<unsigned char> &output);
+
+	// Constructor creates the element buffer, it is empty until one of the uploads
+	IndexBuffer();
+
+	// Destructor releases the element buffer
+	~IndexBuffer();
+
+	// Upload indices into a vertex array at the narrowest type. Strips and fans may contain RESTART
+	void upload(unsigned int vertexArray, const std::vector<unsigned int> &indices, size_t vertexCount, GLenum mode = GL_TRIANGLES);
+
+	// Upload a triangle list with more vertices than 16-bit indices address, splitting it into 16-bit pieces when
+	// the index bytes saved outweigh the vertices duplicated along the seams. remap is left empty if it is not split,
+	// otherwise the vertex buffer has to be rebuilt with remapVertices
+	void uploadTriangles(unsigned int vertexArray, const std::vector<unsigned int> &indices, size_t vertexCount,
+		size_t vertexStride, std::vector<unsigned int> &remap);
+
+	// Bind the vertex array and draw every piece, a split mesh going out with one glMultiDrawElementsBaseVertex
+	void draw() const;
+
+	// Draw count indices from firstIndex of a buffer uploaded in one piece, such as one level of several stored together
+	void drawRange(unsigned int firstIndex, unsigned int count) const;
+
+	// Index type, bytes in the element buffer and the pieces drawn
+	GLenum getType() const;
+	unsigned int getBuffer() const;
+	size_t getByteSize() const;
+	const std::vector<IndexRange> &getRanges() const;
+
+private:
+	// The buffer is owned, so it cannot be copied
+	IndexBuffer(const IndexBuffer &);
+	IndexBuffer &operator=(const IndexBuffer &);
+
+	unsigned int vertexArray;
+	unsigned int buffer;
+	GLenum type;
+	GLenum mode;
+	bool restart;
+	size_t byteSize;
+	std::vector<IndexRange> ranges;
+
+	// Arguments for glMultiDrawElementsBaseVertex, kept alongside the ranges
+	std::vector<GLsizei> counts;
+	std::vector<const void*> offsets;
+	std::vector<GLint> baseVertices;
+
+	// Helper function to narrow indices to the chosen type and store them in the vertex array's element buffer
+	void store(unsigned int targetArray, const std::vector<unsigned int> &indices);
+
+	// Helper function to rebuild the multi-draw arguments from the ranges
+	void setRanges(const std::vector<IndexRange> &newRanges);
+};
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ * IndirectDraw.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Builder for indirect draw commands submitted with a single glMultiDrawElementsIndirect
+ */
+
+#include "IndirectDraw.hpp"
+
+// True if the context has multi-draw indirect and base instance, GL 4.3 or the ARB extensions
+bool IndirectDrawBuilder::isSupported() {
+	return GLEW_VERSION_4_3 || (GLEW_ARB_multi_draw_indirect && GLEW_ARB_draw_indirect && GLEW_ARB_base_instance);
+}
+
+// Constructor creates the command buffer with room for capacity draws, it grows if more are added
+IndirectDrawBuilder::IndirectDrawBuilder(size_t capacity)
+	: buffer(0), capacity(capacity), instances(0), dirty(false) {
+	glGenBuffers(1, &buffer);
+	GLState::bindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, capacity * sizeof(DrawElementsIndirectCommand), NULL, GL_DYNAMIC_DRAW);
+	commands.reserve(capacity);
+}
+
+// Destructor releases the command buffer
+IndirectDrawBuilder::~IndirectDrawBuilder() {
+	GLState::deleteBuffer(buffer);
+}
+
+// Remove every command
+void IndirectDrawBuilder::clear() {
+	commands.clear();
+	instances = 0;
+	dirty = true;
+}
+
+// Add a draw of count indices, returning its draw ID. Base instances carry on from the previous
+// command, so instanced attributes with a divisor of 1 are read per draw, indexed by draw ID
+unsigned int IndirectDrawBuilder::add(unsigned int count, unsigned int firstIndex, int baseVertex, unsigned int instanceCount) {
+	DrawElementsIndirectCommand command;
+	command.count = count;
+	command.instanceCount = instanceCount;
+	command.firstIndex = firstIndex;
+	command.baseVertex = baseVertex;
+	command.baseInstance = instances;
+	commands.push_back(command);
+	instances += instanceCount;
+	dirty = true;
+	return (unsigned int)commands.size() - 1;
+}
+
+// Make room for count single instance draws to be filled in with set. Each draw ID is written once, so separate
+// ranges can be filled by separate jobs
+void IndirectDrawBuilder::resize(size_t count) {
+	commands.resize(count);
+	instances = (unsigned int)count;
+	dirty = true;
+}
+
+// Fill in a draw made room for by resize, its base instance being its draw ID as add would give it
+void IndirectDrawBuilder::set(unsigned int drawId, unsigned int count, unsigned int firstIndex, int baseVertex) {
+	DrawElementsIndirectCommand &command = commands[drawId];
+	command.count = count;
+	command.instanceCount = 1;
+	command.firstIndex = firstIndex;
+	command.baseVertex = baseVertex;
+	command.baseInstance = drawId;
+}
+
+// Issue every command with one call, uploading them first if they changed
+void IndirectDrawBuilder::draw(GLenum mode, GLenum indexType) {
+	if (commands.empty()) {
+		return;
+	}
+	GLState::bindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer);
+	if (dirty) {
+		// Orphan the old storage so a frame still drawing from it is not stalled
+		if (commands.size() > capacity) {
+			capacity = commands.size();
+		}
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, capacity * sizeof(DrawElementsIndirectCommand), NULL, GL_DYNAMIC_DRAW);
+		glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, commands.size() * sizeof(DrawElementsIndirectCommand), commands.data());
+		dirty = false;
+	}
+	glMultiDrawElementsIndirect(mode, indexType, 0, (GLsizei)commands.size(), 0);
+}
+
+// Number of commands, and the instances they cover which is the per-draw data they need
+size_t IndirectDrawBuilder::size() const {
+	return commands.size();
+}
+
+unsigned int IndirectDrawBuilder::getInstanceCount() const {
+	return instances;
+}
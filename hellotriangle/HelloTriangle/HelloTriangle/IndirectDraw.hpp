@@ -0,0 +1,72 @@
+/*
+ * IndirectDraw.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Builder for indirect draw commands submitted with a single glMultiDrawElementsIndirect
+ */
+
+#ifndef INDIRECTDRAW_HPP
+#define INDIRECTDRAW_HPP
+
+#include <GL/glew.h>
+
+#include <vector>
+#include <iostream>
+
+#include "GLState.hpp"
+
+// Layout GL reads from the indirect buffer for each draw
+struct DrawElementsIndirectCommand {
+	unsigned int count;
+	unsigned int instanceCount;
+	unsigned int firstIndex;
+	int baseVertex;
+	unsigned int baseInstance;
+};
+
+class IndirectDrawBuilder {
+public:
+	// True if the context has multi-draw indirect and base instance, GL 4.3 or the ARB extensions
+	static bool isSupported();
+
+	// Constructor creates the command buffer with room for capacity draws, it grows if more are added
+	IndirectDrawBuilder(size_t capacity = 1024);
+
+	// Destructor releases the command buffer
+	~IndirectDrawBuilder();
+
+	// Remove every command
+	void clear();
+
+	// Add a draw of count indices, returning its draw ID. Base instances carry on from the previous
+	// command, so instanced attributes with a divisor of 1 are read per draw, indexed by draw ID
+	unsigned int add(unsigned int count, unsigned int firstIndex, int baseVertex = 0, unsigned int instanceCount = 1);
+
+	// Make room for count single instance draws to be filled in with set. Each draw ID is written once, so separate
+	// ranges can be filled by separate jobs
+	void resize(size_t count);
+
+	// Fill in a draw made room for by resize, its base instance being its draw ID as add would give it
+	void set(unsigned int drawId, unsigned int count, unsigned int firstIndex, int baseVertex = 0);
+
+	// Issue every command with one call, uploading them first if they changed
+	void draw(GLenum mode = GL_TRIANGLES, GLenum indexType = GL_UNSIGNED_INT);
+
+	// Number of commands, and the instances they cover which is the per-draw data they need
+	size_t size() const;
+	unsigned int getInstanceCount() const;
+
+private:
+	// The buffer is owned, so it cannot be copied
+	IndirectDrawBuilder(const IndirectDrawBuilder &);
+	IndirectDrawBuilder &operator=(const IndirectDrawBuilder &);
+
+	unsigned int buffer;
+	size_t capacity;
+	std::vector<DrawElementsIndirectCommand> commands;
+	unsigned int instances;
+	bool dirty;
+};
+
+#endif
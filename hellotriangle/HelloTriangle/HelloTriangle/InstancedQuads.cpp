@@ -0,0 +1,108 @@
+/*
+ * InstancedQuads.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Per-instance quad attributes streamed each frame, drawn with a single glDrawElementsInstanced
+ */
+
+#include "InstancedQuads.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+// Constructor creates a vertex array reading the quad's vertex and element buffers, with the per-instance
+// attributes added. The quad's own vertex array is left untouched
+InstancedQuads::InstancedQuads(unsigned int quadBuffer, const IndexBuffer &quadIndices, size_t capacity)
+	: vertexArray(0), indexType(quadIndices.getType()), stream(new StreamBuffer(capacity * sizeof(QuadInstance))), capacity(capacity), count(0) {
+	glGenVertexArrays(1, &vertexArray);
+	GLState::bindVertexArray(vertexArray);
+	GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadIndices.getBuffer());
+	GLState::bindBuffer(GL_ARRAY_BUFFER, quadBuffer);
+
+	// Set up position, color and texture attributes, laid out as in the quad's vertex buffer
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+	for (unsigned int attribute = 0; attribute <= 2; attribute++) {
+		glEnableVertexAttribArray(attribute);
+	}
+
+	// The attribute pointers are moved on each upload, since every frame writes to a different region
+	setAttributes(0);
+	for (unsigned int attribute = 3; attribute <= 5; attribute++) {
+		glEnableVertexAttribArray(attribute);
+		glVertexAttribDivisor(attribute, 1);
+	}
+}
+
+// Destructor deletes the vertex array, the quad's buffers stay with their owner
+InstancedQuads::~InstancedQuads() {
+	GLState::deleteVertexArray(vertexArray);
+}
+
+// Write this frame's instance data into the stream buffer, growing it if needed
+void InstancedQuads::upload(const std::vector<QuadInstance> &instances) {
+	if (instances.size() > capacity) {
+		capacity = instances.size();
+		stream.reset(new StreamBuffer(capacity * sizeof(QuadInstance)));
+	}
+	count = 0;
+	stream->beginFrame();
+	StreamAllocation allocation = stream->allocate(instances.size() * sizeof(QuadInstance), sizeof(float));
+	if (allocation.data == NULL) {
+		return;
+	}
+	std::memcpy(allocation.data, instances.data(), allocation.size);
+	stream->flush();
+	count = instances.size();
+	setAttributes(allocation.offset);
+}
+
+// Draw the uploaded instances and fence their region, the instanced shader must already be in use
+void InstancedQuads::draw() {
+	if (count == 0) {
+		return;
+	}
+	GLState::bindVertexArray(vertexArray);
+	glDrawElementsInstanced(GL_TRIANGLES, 6, indexType, 0, (GLsizei)count);
+	stream->endFrame();
+}
+
+// Draw through indirect commands instead, each command reads the instances from its base instance on
+void InstancedQuads::draw(IndirectDrawBuilder &commands) {
+	if (count < commands.getInstanceCount()) {
+		std::cout << "Error: indirect commands need " << commands.getInstanceCount() << " instances, "
+			<< count << " were uploaded" << std::endl;
+		return;
+	}
+	GLState::bindVertexArray(vertexArray);
+	commands.draw(GL_TRIANGLES, indexType);
+	stream->endFrame();
+}
+
+// Number of instances uploaded
+size_t InstancedQuads::size() const {
+	return count;
+}
+
+// Buffer the instances are streamed through, for its fence wait counts
+const StreamBuffer &InstancedQuads::getStream() const {
+	return *stream;
+}
+
+// Helper function to point the instance attributes at the data starting at offset in the stream buffer
+void InstancedQuads::setAttributes(size_t offset) {
+	GLState::bindVertexArray(vertexArray);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, stream->buffer);
+	const char* base = (const char*)offset;
+
+	// Set up transform attribute, offset xy, scale and rotation
+	glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), base + offsetof(QuadInstance, x));
+
+	// Set up texture mix attribute
+	glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), base + offsetof(QuadInstance, textureMix));
+
+	// Set up tint attribute
+	glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(QuadInstance), base + offsetof(QuadInstance, tint));
+}
@@ -0,0 +1,71 @@
+/*
+ * InstancedQuads.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Per-instance quad attributes streamed each frame, drawn with a single glDrawElementsInstanced
+ */
+
+#ifndef INSTANCEDQUADS_HPP
+#define INSTANCEDQUADS_HPP
+
+#include <GL/glew.h>
+
+#include <memory>
+#include <vector>
+#include <iostream>
+
+#include "GLState.hpp"
+#include "StreamBuffer.hpp"
+#include "IndirectDraw.hpp"
+#include "IndexBuffer.hpp"
+
+// Attributes of one quad, read by SimpleShader.vert when it is built with INSTANCED
+struct QuadInstance {
+	float x, y;
+	float scale;
+	float rotation;
+	float textureMix;
+	float tint[4];
+};
+
+class InstancedQuads {
+public:
+	// Constructor creates a vertex array reading the quad's vertex and element buffers, with the per-instance
+	// attributes added. The quad's own vertex array is left untouched
+	InstancedQuads(unsigned int quadBuffer, const IndexBuffer &quadIndices, size_t capacity);
+
+	// Destructor deletes the vertex array, the quad's buffers stay with their owner
+	~InstancedQuads();
+
+	// Write this frame's instance data into the stream buffer, growing it if needed
+	void upload(const std::vector<QuadInstance> &instances);
+
+	// Draw the uploaded instances and fence their region, the instanced shader must already be in use
+	void draw();
+
+	// Draw through indirect commands instead, each command reads the instances from its base instance on
+	void draw(IndirectDrawBuilder &commands);
+
+	// Number of instances uploaded
+	size_t size() const;
+
+	// Buffer the instances are streamed through, for its fence wait counts
+	const StreamBuffer &getStream() const;
+
+private:
+	// The vertex array and stream buffer are owned, so they cannot be copied
+	InstancedQuads(const InstancedQuads &);
+	InstancedQuads &operator=(const InstancedQuads &);
+
+	unsigned int vertexArray;
+	GLenum indexType;
+	std::unique_ptr<StreamBuffer> stream;
+	size_t capacity;
+	size_t count;
+
+	// Helper function to point the instance attributes at the data starting at offset in the stream buffer
+	void setAttributes(size_t offset);
+};
+
+#endif
@@ -0,0 +1,333 @@
+/*
+ * JobSystem.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Work-stealing job system, a deque per worker with counters for waiting on groups and chaining dependencies
+ */
+
+#include "JobSystem.hpp"
+
+#include <algorithm>
+
+// A queued task and the group it counts towards
+struct Job {
+	std::function<void()> task;
+	JobCounter* group;
+};
+
+// The system and worker index of the calling thread, so run() knows which deque it owns
+static thread_local const JobSystem* threadSystem = NULL;
+static thread_local int threadWorker = -1;
+
+// Steal order of a thread that is not a worker, seeded from its id on first use
+static thread_local unsigned int outsideRandom = 0;
+
+// Constructor starts with nothing pending
+JobCounter::JobCounter() : pending(0), releasing(0) {
+}
+
+// Destructor waits for a job that finished the group to stop touching it, so a counter only used as a
+// dependency can go out of scope as soon as the jobs depending on it are done
+JobCounter::~JobCounter() {
+	// Seeing pending at zero means the last job already counted itself in releasing, so this cannot miss it
+	while (releasing.load() != 0) {
+		std::this_thread::yield();
+	}
+}
+
+// Whether every job added to the group so far has finished
+bool JobCounter::isDone() const {
+	return pending.load() == 0 && releasing.load() == 0;
+}
+
+// Jobs of the group still queued or running
+int JobCounter::getPending() const {
+	return pending.load(std::memory_order_acquire);
+}
+
+// Constructor allocates room for capacity jobs, a power of two
+WorkStealingDeque::WorkStealingDeque(size_t capacity) : top(0), bottom(0) {
+	size_t size = 1;
+	while (size < capacity) {
+		size <<= 1;
+	}
+	buffer.reset(new std::atomic<Job*>[size]);
+	mask = (long long)size - 1;
+}
+
+// Owner only. Returns false when the deque is full
+bool WorkStealingDeque::push(Job* job) {
+	long long b = bottom.load(std::memory_order_relaxed);
+	long long t = top.load(std::memory_order_acquire);
+	if (b - t > mask) {
+		return false;
+	}
+	buffer[b & mask].store(job, std::memory_order_relaxed);
+	// The job has to be visible before a thief can see the new bottom
+	bottom.store(b + 1, std::memory_order_release);
+	return true;
+}
+
+// Owner only. Takes the most recently pushed job, NULL if there is none
+Job* WorkStealingDeque::pop() {
+	long long b = bottom.load(std::memory_order_relaxed) - 1;
+	bottom.store(b, std::memory_order_relaxed);
+	// Claiming the bottom has to be ordered before reading top, or a thief and the owner could both take the last job
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	long long t = top.load(std::memory_order_relaxed);
+	if (t > b) {
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return NULL;
+	}
+	Job* job = buffer[b & mask].load(std::memory_order_relaxed);
+	if (t == b) {
+		// Last job, race the thieves for it
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			job = NULL;
+		}
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+// Any thread. Takes the oldest job, NULL if there is none or another thread won it
+Job* WorkStealingDeque::steal() {
+	long long t = top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	long long b = bottom.load(std::memory_order_acquire);
+	if (t >= b) {
+		return NULL;
+	}
+	Job* job = buffer[t & mask].load(std::memory_order_relaxed);
+	if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+		return NULL;
+	}
+	return job;
+}
+
+// Constructor starts workerCount - 1 threads, the calling thread being worker 0 that runs jobs while it waits.
+// 0 uses one worker per hardware thread
+JobSystem::JobSystem(unsigned int workerCount) : sharedCount(0), queued(0), sleeping(0), stopping(false) {
+	if (workerCount == 0) {
+		workerCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+	for (unsigned int i = 0; i < workerCount; i++) {
+		workers.push_back(std::unique_ptr<Worker>(new Worker()));
+		workers[i]->executed = 0;
+		workers[i]->stolen = 0;
+		workers[i]->random = 2654435761u * (i + 1);
+	}
+	// A system made inside another one's lifetime takes over the thread until it is destroyed
+	previousSystem = threadSystem;
+	previousWorker = threadWorker;
+	threadSystem = this;
+	threadWorker = 0;
+	for (unsigned int i = 1; i < workerCount; i++) {
+		threads.push_back(std::thread(&JobSystem::workerLoop, this, (int)i));
+	}
+}
+
+// Destructor finishes the queued jobs and joins the threads
+JobSystem::~JobSystem() {
+	// Jobs still queued are run here, so a group nobody waited on does not leak its jobs
+	Job* job;
+	while (queued.load() > 0 && (job = find(currentWorker())) != NULL) {
+		execute(job, currentWorker());
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	for (size_t i = 0; i < threads.size(); i++) {
+		threads[i].join();
+	}
+	if (threadSystem == this) {
+		threadSystem = previousSystem;
+		threadWorker = previousWorker;
+	}
+}
+
+// Queue a task, counted in group if there is one. With a dependency the task is held back until every
+// job of that group has finished
+void JobSystem::run(const std::function<void()> &task, JobCounter* group, JobCounter* dependency) {
+	Job* job = new Job();
+	job->task = task;
+	job->group = group;
+	if (group != NULL) {
+		group->pending.fetch_add(1, std::memory_order_relaxed);
+	}
+	if (dependency != NULL && dependency->pending.load() > 0) {
+		// Checked again under the lock, the last job of the group takes the lock before releasing the waiters
+		std::lock_guard<std::mutex> lock(dependency->waitingMutex);
+		if (dependency->pending.load() > 0) {
+			dependency->waiting.push_back(job);
+			return;
+		}
+	}
+	schedule(job);
+}
+
+// Split [0, count) into batches of batchSize indices and run body on each as a job in group
+void JobSystem::parallelFor(size_t count, size_t batchSize, const std::function<void(size_t begin, size_t end)> &body,
+	JobCounter* group, JobCounter* dependency) {
+	// One copy of the body shared by every batch, instead of a copy per job
+	std::shared_ptr<std::function<void(size_t, size_t)> > shared(new std::function<void(size_t, size_t)>(body));
+	batchSize = std::max((size_t)1, batchSize);
+	for (size_t begin = 0; begin < count; begin += batchSize) {
+		size_t end = std::min(count, begin + batchSize);
+		run([shared, begin, end]() { (*shared)(begin, end); }, group, dependency);
+	}
+}
+
+// Run queued jobs on the calling thread until every job of the group has finished
+void JobSystem::wait(JobCounter &group) {
+	int worker = currentWorker();
+	while (!group.isDone()) {
+		Job* job = find(worker);
+		if (job != NULL) {
+			execute(job, worker);
+		}
+		else {
+			// The rest of the group is running on other workers
+			std::this_thread::yield();
+		}
+	}
+}
+
+// Threads running jobs, including the one that created the system
+unsigned int JobSystem::getWorkerCount() const {
+	return (unsigned int)workers.size();
+}
+
+// Jobs run and stolen by each worker
+JobWorkerStats JobSystem::getWorkerStats(unsigned int worker) const {
+	JobWorkerStats stats = { workers[worker]->executed.load(), workers[worker]->stolen.load() };
+	return stats;
+}
+
+// Print how the jobs were spread over the workers
+void JobSystem::printReport() const {
+	std::cout << "Job system: " << workers.size() << " workers" << std::endl;
+	for (size_t i = 0; i < workers.size(); i++) {
+		std::cout << "  worker " << i << ": " << workers[i]->executed.load() << " jobs run, "
+			<< workers[i]->stolen.load() << " stolen" << std::endl;
+	}
+}
+
+// Helper function to queue a job that is ready to start
+void JobSystem::schedule(Job* job) {
+	int worker = currentWorker();
+	if (worker == -1 || !workers[worker]->deque.push(job)) {
+		std::lock_guard<std::mutex> lock(sharedMutex);
+		shared.push_back(job);
+		sharedCount.fetch_add(1);
+	}
+	queued.fetch_add(1);
+	// Sleepers count themselves before checking queued, so one side always sees the other
+	if (sleeping.load() > 0) {
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		wake.notify_one();
+	}
+}
+
+// Helper function to take a job from the worker's own deque, the shared queue or another worker. A worker of
+// -1 is a thread that is not a worker, which owns no deque and may steal from all of them
+Job* JobSystem::find(int worker) {
+	Job* job = NULL;
+	if (worker != -1 && currentWorker() == worker) {
+		job = workers[worker]->deque.pop();
+	}
+	// The count is read without the lock, so workers only contend for it when it has jobs
+	if (job == NULL && sharedCount.load() > 0) {
+		std::lock_guard<std::mutex> lock(sharedMutex);
+		if (!shared.empty()) {
+			job = shared.front();
+			shared.pop_front();
+			sharedCount.fetch_sub(1);
+		}
+	}
+	// Start at a random victim so thieves spread out instead of all hitting worker 0
+	size_t count = workers.size();
+	if (job == NULL && (count > 1 || worker == -1)) {
+		if (worker == -1 && outsideRandom == 0) {
+			outsideRandom = (unsigned int)std::hash<std::thread::id>()(std::this_thread::get_id()) | 1u;
+		}
+		unsigned int &random = worker == -1 ? outsideRandom : workers[worker]->random;
+		random = random * 1664525u + 1013904223u;
+		size_t start = (random >> 8) % count;
+		for (size_t i = 0; i < count && job == NULL; i++) {
+			size_t victim = (start + i) % count;
+			if ((int)victim != worker) {
+				job = workers[victim]->deque.steal();
+			}
+		}
+		if (job != NULL && worker != -1) {
+			workers[worker]->stolen.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	if (job != NULL) {
+		queued.fetch_sub(1);
+	}
+	return job;
+}
+
+// Helper function to run a job and release the jobs waiting on its group if it was the last one
+void JobSystem::execute(Job* job, int worker) {
+	job->task();
+	// Jobs run by threads that are not workers are not counted against any worker
+	if (worker != -1) {
+		workers[worker]->executed.fetch_add(1, std::memory_order_relaxed);
+	}
+	JobCounter* group = job->group;
+	delete job;
+	if (group == NULL) {
+		return;
+	}
+	// A waiter may destroy the counter as soon as it looks done, so releasing covers the time this thread still
+	// touches it after pending reaches zero
+	group->releasing.fetch_add(1);
+	std::vector<Job*> released;
+	if (group->pending.fetch_sub(1) == 1) {
+		std::lock_guard<std::mutex> lock(group->waitingMutex);
+		released.swap(group->waiting);
+	}
+	group->releasing.fetch_sub(1);
+	for (size_t i = 0; i < released.size(); i++) {
+		schedule(released[i]);
+	}
+}
+
+// Helper function for the body of each started thread
+void JobSystem::workerLoop(int worker) {
+	threadSystem = this;
+	threadWorker = worker;
+	int idle = 0;
+	while (true) {
+		Job* job = find(worker);
+		if (job != NULL) {
+			execute(job, worker);
+			idle = 0;
+			continue;
+		}
+		// Spin briefly in case more jobs are about to arrive, then sleep
+		if (++idle < 64) {
+			std::this_thread::yield();
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleeping.fetch_add(1);
+		wake.wait(lock, [this]() { return stopping.load() || queued.load() > 0; });
+		sleeping.fetch_sub(1);
+		if (stopping.load() && queued.load() == 0) {
+			return;
+		}
+		idle = 0;
+	}
+}
+
+// Helper function giving the calling thread's worker index in this system, -1 if it is not one
+int JobSystem::currentWorker() const {
+	return threadSystem == this ? threadWorker : -1;
+}
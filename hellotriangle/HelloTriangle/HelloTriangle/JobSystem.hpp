@@ -0,0 +1,169 @@
+/*
+ * JobSystem.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Work-stealing job system, a deque per worker with counters for waiting on groups and chaining dependencies
+ */
+
+#ifndef JOBSYSTEM_HPP
+#define JOBSYSTEM_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <vector>
+
+struct Job;
+
+// Number of unfinished jobs in a group. Jobs can be made to wait for a group to finish before they start
+class JobCounter {
+public:
+	// Constructor starts with nothing pending
+	JobCounter();
+
+	// Destructor waits for a job that finished the group to stop touching it, so a counter only used as a
+	// dependency can go out of scope as soon as the jobs depending on it are done
+	~JobCounter();
+
+	// Whether every job added to the group so far has finished
+	bool isDone() const;
+
+	// Jobs of the group still queued or running
+	int getPending() const;
+
+private:
+	friend class JobSystem;
+
+	// Waiting jobs point at the counter, so it cannot be copied
+	JobCounter(const JobCounter &);
+	JobCounter &operator=(const JobCounter &);
+
+	std::atomic<int> pending;
+	std::atomic<int> releasing;
+	// Jobs to queue once pending reaches zero, only locked when a job depends on an unfinished group
+	std::mutex waitingMutex;
+	std::vector<Job*> waiting;
+};
+
+// Fixed size Chase-Lev deque. The owning worker pushes and pops at the bottom without locks, other workers
+// steal from the top with a compare and swap
+class WorkStealingDeque {
+public:
+	// Constructor allocates room for capacity jobs, a power of two
+	WorkStealingDeque(size_t capacity = 4096);
+
+	// Owner only. Returns false when the deque is full
+	bool push(Job* job);
+
+	// Owner only. Takes the most recently pushed job, NULL if there is none
+	Job* pop();
+
+	// Any thread. Takes the oldest job, NULL if there is none or another thread won it
+	Job* steal();
+
+private:
+	WorkStealingDeque(const WorkStealingDeque &);
+	WorkStealingDeque &operator=(const WorkStealingDeque &);
+
+	// Thieves move top and the owner moves bottom, so a cache line of padding keeps them from false sharing
+	std::atomic<long long> top;
+	char padding[64];
+	std::atomic<long long> bottom;
+	std::unique_ptr<std::atomic<Job*>[]> buffer;
+	long long mask;
+};
+
+// Jobs run and stolen by one worker since the system started
+struct JobWorkerStats {
+	unsigned long long executed;
+	unsigned long long stolen;
+};
+
+class JobSystem {
+public:
+	// Constructor starts workerCount - 1 threads, the calling thread being worker 0 that runs jobs while it waits.
+	// 0 uses one worker per hardware thread
+	JobSystem(unsigned int workerCount = 0);
+
+	// Destructor finishes the queued jobs and joins the threads
+	~JobSystem();
+
+	// Queue a task, counted in group if there is one. With a dependency the task is held back until every
+	// job of that group has finished
+	void run(const std::function<void()> &task, JobCounter* group = NULL, JobCounter* dependency = NULL);
+
+	// Split [0, count) into batches of batchSize indices and run body on each as a job in group
+	void parallelFor(size_t count, size_t batchSize, const std::function<void(size_t begin, size_t end)> &body,
+		JobCounter* group, JobCounter* dependency = NULL);
+
+	// Run queued jobs on the calling thread until every job of the group has finished
+	void wait(JobCounter &group);
+
+	// Threads running jobs, including the one that created the system
+	unsigned int getWorkerCount() const;
+
+	// Jobs run and stolen by each worker
+	JobWorkerStats getWorkerStats(unsigned int worker) const;
+
+	// Print how the jobs were spread over the workers
+	void printReport() const;
+
+private:
+	// Threads and queues are owned, so it cannot be copied
+	JobSystem(const JobSystem &);
+	JobSystem &operator=(const JobSystem &);
+
+	// Per worker queue and counts. Workers are allocated separately, and a cache line of padding at each end keeps
+	// one worker's fields off the lines of whatever the allocator put next to it
+	struct Worker {
+		char leading[64];
+		WorkStealingDeque deque;
+		std::atomic<unsigned long long> executed;
+		std::atomic<unsigned long long> stolen;
+		unsigned int random;
+		char trailing[64];
+	};
+
+	std::vector<std::unique_ptr<Worker> > workers;
+	std::vector<std::thread> threads;
+
+	// Whichever system the creating thread belonged to before, given back on destruction
+	const JobSystem* previousSystem;
+	int previousWorker;
+
+	// Jobs queued by threads that are not workers, or when a worker's deque is full
+	std::mutex sharedMutex;
+	std::deque<Job*> shared;
+	std::atomic<int> sharedCount;
+
+	// Idle workers sleep until a job is queued
+	std::atomic<int> queued;
+	std::atomic<int> sleeping;
+	std::atomic<bool> stopping;
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+
+	// Helper function to queue a job that is ready to start
+	void schedule(Job* job);
+
+	// Helper function to take a job from the worker's own deque, the shared queue or another worker. A worker of
+	// -1 is a thread that is not a worker, which owns no deque and may steal from all of them
+	Job* find(int worker);
+
+	// Helper function to run a job and release the jobs waiting on its group if it was the last one
+	void execute(Job* job, int worker);
+
+	// Helper function for the body of each started thread
+	void workerLoop(int worker);
+
+	// Helper function giving the calling thread's worker index in this system, -1 if it is not one
+	int currentWorker() const;
+};
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * MeshLod.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Chains of simplified index buffers over one vertex buffer, and level selection by screen size
+ */
+
+#include "MeshLod.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshSimplifier.hpp"
+
+#include <cmath>
+
+// Constructor starts with no levels
+MeshLod::MeshLod() {
+}
+
+// Build the chain, level 0 being the mesh itself and each further level simplified from the one before
+// to ratio of its indices. Stops after maxLevels, or when a level no longer shrinks by a useful amount.
+// positionStride is in bytes
+void MeshLod::build(const std::vector<unsigned int> &source, const float* positions, size_t positionStride,
+	size_t vertexCount, int maxLevels, float ratio) {
+	indices = source;
+	levels.clear();
+	LodLevel full = { 0, (unsigned int)source.size(), 0.0f };
+	levels.push_back(full);
+
+	std::vector<unsigned int> previous = source;
+	std::vector<unsigned int> simplified;
+	float error = 0.0f;
+	while ((int)levels.size() < maxLevels) {
+		size_t target = (size_t)(previous.size() * ratio) / 3 * 3;
+		error += MeshSimplifier::simplify(previous, positions, positionStride, vertexCount, target, simplified);
+		// Locked seams and borders stop the simplifier short, a level barely smaller is not worth storing
+		if (simplified.empty() || simplified.size() > previous.size() * (ratio + 1.0f) / 2.0f) {
+			break;
+		}
+		// Collapses leave the triangles in the order they were, so each level is reordered for the cache itself
+		MeshOptimizer::optimizeVertexCache(simplified, vertexCount);
+
+		LodLevel level = { (unsigned int)indices.size(), (unsigned int)simplified.size(), error };
+		levels.push_back(level);
+		indices.insert(indices.end(), simplified.begin(), simplified.end());
+		previous.swap(simplified);
+	}
+}
+
+// Store every level in one element buffer of a vertex array that already holds the shared vertex buffer
+void MeshLod::upload(unsigned int vertexArray, size_t vertexCount) {
+	indexBuffer.upload(vertexArray, indices, vertexCount, GL_TRIANGLES);
+}
+
+// Draw one level
+void MeshLod::draw(int level) const {
+	if (level < 0 || level >= (int)levels.size()) {
+		return;
+	}
+	indexBuffer.drawRange(levels[level].firstIndex, levels[level].count);
+}
+
+// Levels in the chain, from full detail down
+int MeshLod::getLevelCount() const {
+	return (int)levels.size();
+}
+
+const LodLevel &MeshLod::getLevel(int level) const {
+	return levels[level];
+}
+
+// Print the triangle count and error of each level
+void MeshLod::printReport(const std::string &name) const {
+	std::cout << "LOD chain " << name << ": " << levels.size() << " levels, "
+		<< indexBuffer.getByteSize() / 1024.0 << " KB of indices" << std::endl;
+	for (size_t i = 0; i < levels.size(); i++) {
+		std::cout << "  level " << i << ": " << levels[i].count / 3 << " triangles, error "
+			<< levels[i].error * 100.0f << "% of extent" << std::endl;
+	}
+}
+
+// Level 0 is used down to fullDetailSize pixels, and each further level over the next factor of step in size.
+// A level only changes once the size is hysteresis past a boundary, so objects sitting near one do not flicker
+LodSelector::LodSelector(float fullDetailSize, float step, float hysteresis)
+	: fullDetailSize(fullDetailSize), step(step), hysteresis(hysteresis) {
+}
+
+// Height in pixels of a sphere of radius at distance, under a perspective projection with fovY in radians
+float LodSelector::projectedSize(float radius, float distance, float fovY, float viewportHeight) {
+	if (distance <= radius) {
+		return viewportHeight;
+	}
+	return radius / (distance * std::tan(fovY * 0.5f)) * viewportHeight;
+}
+
+// Pick the level for this frame from the projected size and the level used last frame
+int LodSelector::select(int current, float screenSize, int levelCount) const {
+	int level = current < 0 ? 0 : (current >= levelCount ? levelCount - 1 : current);
+	// Level l hands over to level l + 1 below fullDetailSize * step^l
+	while (level + 1 < levelCount && screenSize < fullDetailSize * std::pow(step, (float)level) * (1.0f - hysteresis)) {
+		level++;
+	}
+	while (level > 0 && screenSize > fullDetailSize * std::pow(step, (float)(level - 1)) * (1.0f + hysteresis)) {
+		level--;
+	}
+	return level;
+}
@@ -0,0 +1,79 @@
+/*
+ * MeshLod.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Chains of simplified index buffers over one vertex buffer, and level selection by screen size
+ */
+
+#ifndef MESHLOD_HPP
+#define MESHLOD_HPP
+
+#include <GL/glew.h>
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "IndexBuffer.hpp"
+
+// One level of detail, a range of the shared element buffer
+struct LodLevel {
+	unsigned int firstIndex;
+	unsigned int count;
+	float error;
+};
+
+class MeshLod {
+public:
+	// Constructor starts with no levels
+	MeshLod();
+
+	// Build the chain, level 0 being the mesh itself and each further level simplified from the one before
+	// to ratio of its indices. Stops after maxLevels, or when a level no longer shrinks by a useful amount.
+	// positionStride is in bytes
+	void build(const std::vector<unsigned int> &source, const float* positions, size_t positionStride,
+		size_t vertexCount, int maxLevels = 6, float ratio = 0.5f);
+
+	// Store every level in one element buffer of a vertex array that already holds the shared vertex buffer
+	void upload(unsigned int vertexArray, size_t vertexCount);
+
+	// Draw one level
+	void draw(int level) const;
+
+	// Levels in the chain, from full detail down
+	int getLevelCount() const;
+	const LodLevel &getLevel(int level) const;
+
+	// Print the triangle count and error of each level
+	void printReport(const std::string &name) const;
+
+private:
+	// The element buffer is owned, so it cannot be copied
+	MeshLod(const MeshLod &);
+	MeshLod &operator=(const MeshLod &);
+
+	std::vector<unsigned int> indices;
+	std::vector<LodLevel> levels;
+	IndexBuffer indexBuffer;
+};
+
+class LodSelector {
+public:
+	// Level 0 is used down to fullDetailSize pixels, and each further level over the next factor of step in size.
+	// A level only changes once the size is hysteresis past a boundary, so objects sitting near one do not flicker
+	LodSelector(float fullDetailSize, float step = 0.5f, float hysteresis = 0.1f);
+
+	// Height in pixels of a sphere of radius at distance, under a perspective projection with fovY in radians
+	static float projectedSize(float radius, float distance, float fovY, float viewportHeight);
+
+	// Pick the level for this frame from the projected size and the level used last frame
+	int select(int current, float screenSize, int levelCount) const;
+
+private:
+	float fullDetailSize;
+	float step;
+	float hysteresis;
+};
+
+#endif
@@ -0,0 +1,294 @@
+/*
+ * MeshOptimizer.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Triangle reordering for the post-transform vertex cache and for less overdraw, and vertex fetch ordering
+ */
+
+#include "MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Size of the LRU cache the triangle scores model, larger than real caches so the order suits any of them
+static const int MODEL_CACHE_SIZE = 32;
+
+// Forsyth's vertex score: vertices of the last triangle score a flat 0.75, older cache entries fall off with
+// their position, and vertices with few triangles left get a boost so they are finished off
+static float vertexScore(int cachePosition, unsigned int remaining) {
+	if (remaining == 0) {
+		return -1.0f;
+	}
+	float score = 0.0f;
+	if (cachePosition >= 0) {
+		if (cachePosition < 3) {
+			score = 0.75f;
+		}
+		else {
+			score = std::pow(1.0f - (float)(cachePosition - 3) / (MODEL_CACHE_SIZE - 3), 1.5f);
+		}
+	}
+	return score + 2.0f / std::sqrt((float)remaining);
+}
+
+// Helper function to run one triangle through a FIFO cache simulation, returning how many corners missed.
+// A vertex is cached if fewer than cacheSize misses have happened since it was loaded, so adding
+// cacheSize + 1 to time empties the cache
+static int cacheMisses(const unsigned int* corners, std::vector<unsigned int> &cacheTime, unsigned int &time, unsigned int cacheSize) {
+	int misses = 0;
+	for (int c = 0; c < 3; c++) {
+		if (time - cacheTime[corners[c]] > cacheSize) {
+			cacheTime[corners[c]] = time++;
+			misses++;
+		}
+	}
+	return misses;
+}
+
+// Reorder a triangle list so consecutive triangles reuse recently transformed vertices, using
+// Forsyth's linear-speed scoring over a 32 entry LRU cache model
+void MeshOptimizer::optimizeVertexCache(std::vector<unsigned int> &indices, size_t vertexCount) {
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+
+	// Triangles around each vertex, the live ones kept at the front of each list
+	std::vector<unsigned int> remaining(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; i++) {
+		remaining[indices[i]]++;
+	}
+	std::vector<unsigned int> firstAdjacent(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++) {
+		firstAdjacent[v + 1] = firstAdjacent[v] + remaining[v];
+	}
+	std::vector<unsigned int> adjacent(triangleCount * 3);
+	std::vector<unsigned int> filled(firstAdjacent.begin(), firstAdjacent.end() - 1);
+	for (size_t i = 0; i < triangleCount * 3; i++) {
+		adjacent[filled[indices[i]]++] = (unsigned int)(i / 3);
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> score(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++) {
+		score[v] = vertexScore(-1, remaining[v]);
+	}
+	std::vector<float> triangleScore(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+	int best = 0;
+	for (size_t t = 0; t < triangleCount; t++) {
+		triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+		if (triangleScore[t] > triangleScore[best]) {
+			best = (int)t;
+		}
+	}
+
+	std::vector<unsigned int> output;
+	output.reserve(triangleCount * 3);
+	unsigned int cache[MODEL_CACHE_SIZE + 3];
+	int cacheCount = 0;
+	size_t cursor = 0;
+
+	while (best != -1) {
+		const unsigned int* corners = &indices[best * 3];
+		output.insert(output.end(), corners, corners + 3);
+		emitted[best] = true;
+
+		// Take the triangle out of its vertices' live lists
+		for (int c = 0; c < 3; c++) {
+			unsigned int v = corners[c];
+			unsigned int* list = &adjacent[firstAdjacent[v]];
+			for (unsigned int i = 0; i < remaining[v]; i++) {
+				if (list[i] == (unsigned int)best) {
+					std::swap(list[i], list[remaining[v] - 1]);
+					remaining[v]--;
+					break;
+				}
+			}
+		}
+
+		// The triangle's vertices move to the front of the cache, pushing the oldest entries out
+		unsigned int updated[MODEL_CACHE_SIZE + 3];
+		int updatedCount = 0;
+		for (int c = 0; c < 3; c++) {
+			if (std::find(updated, updated + updatedCount, corners[c]) == updated + updatedCount) {
+				updated[updatedCount++] = corners[c];
+			}
+		}
+		int triangleVertices = updatedCount;
+		for (int i = 0; i < cacheCount; i++) {
+			if (std::find(updated, updated + triangleVertices, cache[i]) == updated + triangleVertices) {
+				updated[updatedCount++] = cache[i];
+			}
+		}
+
+		// Rescore every vertex whose position changed, including the ones pushed out, then their live triangles
+		best = -1;
+		float bestScore = -1.0f;
+		for (int i = 0; i < updatedCount; i++) {
+			unsigned int v = updated[i];
+			cachePosition[v] = i < MODEL_CACHE_SIZE ? i : -1;
+			score[v] = vertexScore(cachePosition[v], remaining[v]);
+		}
+		for (int i = 0; i < updatedCount; i++) {
+			unsigned int v = updated[i];
+			const unsigned int* list = &adjacent[firstAdjacent[v]];
+			for (unsigned int j = 0; j < remaining[v]; j++) {
+				unsigned int t = list[j];
+				triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+				if (triangleScore[t] > bestScore) {
+					bestScore = triangleScore[t];
+					best = (int)t;
+				}
+			}
+		}
+		cacheCount = std::min(updatedCount, MODEL_CACHE_SIZE);
+		std::copy(updated, updated + cacheCount, cache);
+
+		// Nothing left around the cache, so carry on from the next triangle not yet emitted
+		if (best == -1) {
+			while (cursor < triangleCount && emitted[cursor]) {
+				cursor++;
+			}
+			best = cursor < triangleCount ? (int)cursor : -1;
+		}
+	}
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+// Reorder clusters of a cache-optimized triangle list so outward facing clusters far from the centre draw
+// first and hide what is behind them. Clusters keep their own order, and are only made small enough that
+// the cache miss ratio rises by at most threshold. positionStride is in bytes
+void MeshOptimizer::optimizeOverdraw(std::vector<unsigned int> &indices, const float* positions, size_t positionStride,
+	size_t vertexCount, float threshold) {
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+	const unsigned char* base = (const unsigned char*)positions;
+
+	// Hard boundaries are triangles where the cache misses every corner, so nothing is lost by breaking there
+	const unsigned int cacheSize = 16;
+	std::vector<unsigned int> cacheTime(vertexCount, 0);
+	unsigned int time = cacheSize + 1;
+	std::vector<size_t> hardStart;
+	size_t meshMisses = 0;
+	for (size_t t = 0; t < triangleCount; t++) {
+		int misses = cacheMisses(&indices[t * 3], cacheTime, time, cacheSize);
+		if (t == 0 || misses == 3) {
+			hardStart.push_back(t);
+		}
+		meshMisses += misses;
+	}
+	hardStart.push_back(triangleCount);
+	float meshRatio = (float)meshMisses / triangleCount;
+
+	// Soft boundaries split each hard cluster as soon as its own miss ratio, from a cold cache, is back
+	// down to threshold times the mesh's, which bounds how much worse the reordered list can get
+	std::vector<size_t> clusterStart;
+	for (size_t h = 0; h + 1 < hardStart.size(); h++) {
+		size_t softStart = hardStart[h];
+		size_t misses = 0;
+		clusterStart.push_back(softStart);
+		time += cacheSize + 1;
+		for (size_t t = hardStart[h]; t < hardStart[h + 1]; t++) {
+			misses += cacheMisses(&indices[t * 3], cacheTime, time, cacheSize);
+			if (t + 1 < hardStart[h + 1] && misses <= threshold * meshRatio * (t + 1 - softStart)) {
+				softStart = t + 1;
+				misses = 0;
+				clusterStart.push_back(softStart);
+				time += cacheSize + 1;
+			}
+		}
+	}
+	clusterStart.push_back(triangleCount);
+	size_t clusterCount = clusterStart.size() - 1;
+
+	// Area weighted centroid and normal of each cluster, and of the whole mesh
+	std::vector<float> clusterData(clusterCount * 6, 0.0f);
+	float meshCentroid[3] = { 0.0f, 0.0f, 0.0f };
+	float meshArea = 0.0f;
+	for (size_t k = 0; k < clusterCount; k++) {
+		float* data = &clusterData[k * 6];
+		float clusterArea = 0.0f;
+		for (size_t t = clusterStart[k]; t < clusterStart[k + 1]; t++) {
+			const float* p0 = (const float*)(base + indices[t * 3] * positionStride);
+			const float* p1 = (const float*)(base + indices[t * 3 + 1] * positionStride);
+			const float* p2 = (const float*)(base + indices[t * 3 + 2] * positionStride);
+			float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			float normal[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			float area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			for (int a = 0; a < 3; a++) {
+				data[a] += (p0[a] + p1[a] + p2[a]) / 3.0f * area;
+				data[3 + a] += normal[a];
+			}
+			clusterArea += area;
+		}
+		for (int a = 0; a < 3; a++) {
+			meshCentroid[a] += data[a];
+			data[a] = clusterArea > 0.0f ? data[a] / clusterArea : 0.0f;
+		}
+		meshArea += clusterArea;
+	}
+	for (int a = 0; a < 3; a++) {
+		meshCentroid[a] = meshArea > 0.0f ? meshCentroid[a] / meshArea : 0.0f;
+	}
+
+	// Clusters facing away from the centre and far out along their normal are the likeliest occluders
+	std::vector<float> sortKey(clusterCount);
+	std::vector<unsigned int> order(clusterCount);
+	for (size_t k = 0; k < clusterCount; k++) {
+		const float* data = &clusterData[k * 6];
+		float length = std::sqrt(data[3] * data[3] + data[4] * data[4] + data[5] * data[5]);
+		float dot = 0.0f;
+		for (int a = 0; a < 3; a++) {
+			dot += (data[a] - meshCentroid[a]) * data[3 + a];
+		}
+		sortKey[k] = length > 0.0f ? dot / length : 0.0f;
+		order[k] = (unsigned int)k;
+	}
+	std::stable_sort(order.begin(), order.end(), [&sortKey](unsigned int a, unsigned int b) {
+		return sortKey[a] > sortKey[b];
+	});
+
+	std::vector<unsigned int> output;
+	output.reserve(indices.size());
+	for (size_t k = 0; k < clusterCount; k++) {
+		size_t first = clusterStart[order[k]] * 3, last = clusterStart[order[k] + 1] * 3;
+		output.insert(output.end(), indices.begin() + first, indices.begin() + last);
+	}
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+// Number vertices in the order the triangles first use them and rewrite the indices to match.
+// Output vertex i is source vertex remap[i], for IndexBuffer::remapVertices, unused vertices are dropped
+void MeshOptimizer::optimizeVertexFetch(std::vector<unsigned int> &indices, size_t vertexCount, std::vector<unsigned int> &remap) {
+	const unsigned int UNUSED = 0xFFFFFFFFu;
+	std::vector<unsigned int> newIndex(vertexCount, UNUSED);
+	remap.clear();
+	for (size_t i = 0; i < indices.size(); i++) {
+		unsigned int v = indices[i];
+		if (newIndex[v] == UNUSED) {
+			newIndex[v] = (unsigned int)remap.size();
+			remap.push_back(v);
+		}
+		indices[i] = newIndex[v];
+	}
+}
+
+// Average cache miss ratio, vertices transformed per triangle, through a FIFO cache like most hardware has
+float MeshOptimizer::averageCacheMissRatio(const std::vector<unsigned int> &indices, size_t vertexCount, unsigned int cacheSize) {
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) {
+		return 0.0f;
+	}
+	std::vector<unsigned int> cacheTime(vertexCount, 0);
+	unsigned int time = cacheSize + 1;
+	size_t misses = 0;
+	for (size_t t = 0; t < triangleCount; t++) {
+		misses += cacheMisses(&indices[t * 3], cacheTime, time, cacheSize);
+	}
+	return (float)misses / triangleCount;
+}
@@ -0,0 +1,35 @@
+/*
+ * MeshOptimizer.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Triangle reordering for the post-transform vertex cache and for less overdraw, and vertex fetch ordering
+ */
+
+#ifndef MESHOPTIMIZER_HPP
+#define MESHOPTIMIZER_HPP
+
+#include <cstddef>
+#include <vector>
+
+class MeshOptimizer {
+public:
+	// Reorder a triangle list so consecutive triangles reuse recently transformed vertices, using
+	// Forsyth's linear-speed scoring over a 32 entry LRU cache model
+	static void optimizeVertexCache(std::vector<unsigned int> &indices, size_t vertexCount);
+
+	// Reorder clusters of a cache-optimized triangle list so outward facing clusters far from the centre draw
+	// first and hide what is behind them. Clusters keep their own order, and are only made small enough that
+	// the cache miss ratio rises by at most threshold. positionStride is in bytes
+	static void optimizeOverdraw(std::vector<unsigned int> &indices, const float* positions, size_t positionStride,
+		size_t vertexCount, float threshold = 1.05f);
+
+	// Number vertices in the order the triangles first use them and rewrite the indices to match.
+	// Output vertex i is source vertex remap[i], for IndexBuffer::remapVertices, unused vertices are dropped
+	static void optimizeVertexFetch(std::vector<unsigned int> &indices, size_t vertexCount, std::vector<unsigned int> &remap);
+
+	// Average cache miss ratio, vertices transformed per triangle, through a FIFO cache like most hardware has
+	static float averageCacheMissRatio(const std::vector<unsigned int> &indices, size_t vertexCount, unsigned int cacheSize = 16);
+};
+
+#endif
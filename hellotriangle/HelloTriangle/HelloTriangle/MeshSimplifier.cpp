@@ -0,0 +1,296 @@
+/*
+ * MeshSimplifier.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Quadric error metric simplification by collapsing edges onto existing vertices
+ */
+
+#include "MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// Sum of squared distances to a set of planes, as the symmetric 4x4 matrix of Garland and Heckbert,
+// and the total area the planes were weighted by
+struct Quadric {
+	double a2, b2, c2, ab, ac, bc, ad, bd, cd, d2;
+	double weight;
+};
+
+// Edge collapse moving the vertex from onto the vertex to
+struct Collapse {
+	unsigned int from;
+	unsigned int to;
+	float error;
+};
+
+// Helper function to add the area weighted plane of a triangle to a quadric
+static void addPlane(Quadric &q, const float* p0, const float* p1, const float* p2) {
+	double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+	double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+	double n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+	double length = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+	if (length == 0.0) {
+		return;
+	}
+	n[0] /= length;
+	n[1] /= length;
+	n[2] /= length;
+	double d = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+	double weight = length * 0.5;
+	q.a2 += weight * n[0] * n[0];
+	q.b2 += weight * n[1] * n[1];
+	q.c2 += weight * n[2] * n[2];
+	q.ab += weight * n[0] * n[1];
+	q.ac += weight * n[0] * n[2];
+	q.bc += weight * n[1] * n[2];
+	q.ad += weight * n[0] * d;
+	q.bd += weight * n[1] * d;
+	q.cd += weight * n[2] * d;
+	q.d2 += weight * d * d;
+	q.weight += weight;
+}
+
+// Helper function to add one quadric into another
+static void addQuadric(Quadric &q, const Quadric &other) {
+	q.a2 += other.a2; q.b2 += other.b2; q.c2 += other.c2;
+	q.ab += other.ab; q.ac += other.ac; q.bc += other.bc;
+	q.ad += other.ad; q.bd += other.bd; q.cd += other.cd;
+	q.d2 += other.d2;
+	q.weight += other.weight;
+}
+
+// Helper function to evaluate a quadric at a point, the area weighted mean squared distance to its planes
+static double quadricError(const Quadric &q, const float* p) {
+	if (q.weight == 0.0) {
+		return 0.0;
+	}
+	double x = p[0], y = p[1], z = p[2];
+	double error = q.a2 * x * x + q.b2 * y * y + q.c2 * z * z
+		+ 2.0 * (q.ab * x * y + q.ac * x * z + q.bc * y * z + q.ad * x + q.bd * y + q.cd * z) + q.d2;
+	return error > 0.0 ? error / q.weight : 0.0;
+}
+
+// Helper function to compare positions, for finding the vertices that share one
+static bool samePosition(const float* a, const float* b) {
+	return a[0] == b[0] && a[1] == b[1] && a[2] == b[2];
+}
+
+// Collapse edges of a triangle list, cheapest quadric error first, until at most targetIndexCount indices
+// are left or no collapse is possible. Vertices only move onto other vertices, so the output indexes the
+// same vertex buffer. Attribute seams, where vertices share a position, and open borders are kept in
+// place. Returns the largest error introduced, as a distance relative to the mesh's extent.
+// positionStride is in bytes
+float MeshSimplifier::simplify(const std::vector<unsigned int> &indices, const float* positions, size_t positionStride,
+	size_t vertexCount, size_t targetIndexCount, std::vector<unsigned int> &output) {
+	output = indices;
+	if (indices.size() <= targetIndexCount || vertexCount == 0) {
+		return 0.0f;
+	}
+
+	// Positions scaled to the extent of the mesh, so errors mean the same for any size of model
+	std::vector<float> scaled(vertexCount * 3);
+	float minimum[3], maximum[3];
+	for (size_t v = 0; v < vertexCount; v++) {
+		const float* p = (const float*)((const unsigned char*)positions + v * positionStride);
+		for (int a = 0; a < 3; a++) {
+			scaled[v * 3 + a] = p[a];
+			minimum[a] = v == 0 ? p[a] : std::min(minimum[a], p[a]);
+			maximum[a] = v == 0 ? p[a] : std::max(maximum[a], p[a]);
+		}
+	}
+	float extent = std::max(maximum[0] - minimum[0], std::max(maximum[1] - minimum[1], maximum[2] - minimum[2]));
+	float inverseExtent = extent > 0.0f ? 1.0f / extent : 1.0f;
+	for (size_t i = 0; i < scaled.size(); i++) {
+		scaled[i] *= inverseExtent;
+	}
+
+	// Seam vertices share their position with another vertex and would tear the surface if moved
+	std::vector<bool> locked(vertexCount, false);
+	std::vector<unsigned int> byPosition(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++) {
+		byPosition[v] = (unsigned int)v;
+	}
+	std::sort(byPosition.begin(), byPosition.end(), [&scaled](unsigned int a, unsigned int b) {
+		const float* pa = &scaled[a * 3];
+		const float* pb = &scaled[b * 3];
+		return pa[0] != pb[0] ? pa[0] < pb[0] : (pa[1] != pb[1] ? pa[1] < pb[1] : pa[2] < pb[2]);
+	});
+	for (size_t i = 1; i < vertexCount; i++) {
+		if (samePosition(&scaled[byPosition[i] * 3], &scaled[byPosition[i - 1] * 3])) {
+			locked[byPosition[i]] = true;
+			locked[byPosition[i - 1]] = true;
+		}
+	}
+
+	// Border vertices sit on an edge used by only one triangle
+	std::vector<unsigned long long> edges;
+	edges.reserve(indices.size());
+	for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+		for (int e = 0; e < 3; e++) {
+			unsigned int a = indices[t + e], b = indices[t + (e + 1) % 3];
+			edges.push_back((unsigned long long)std::min(a, b) << 32 | std::max(a, b));
+		}
+	}
+	std::sort(edges.begin(), edges.end());
+	for (size_t i = 0; i < edges.size(); ) {
+		size_t j = i + 1;
+		while (j < edges.size() && edges[j] == edges[i]) {
+			j++;
+		}
+		if (j - i == 1) {
+			locked[(unsigned int)(edges[i] >> 32)] = true;
+			locked[(unsigned int)edges[i]] = true;
+		}
+		i = j;
+	}
+
+	std::vector<Quadric> quadrics(vertexCount);
+	std::fill(quadrics.begin(), quadrics.end(), Quadric());
+	for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+		const float* p0 = &scaled[indices[t] * 3];
+		const float* p1 = &scaled[indices[t + 1] * 3];
+		const float* p2 = &scaled[indices[t + 2] * 3];
+		for (int c = 0; c < 3; c++) {
+			addPlane(quadrics[indices[t + c]], p0, p1, p2);
+		}
+	}
+
+	std::vector<unsigned int> remap(vertexCount);
+	std::vector<bool> touched(vertexCount);
+	std::vector<unsigned int> firstAdjacent(vertexCount + 1);
+	std::vector<unsigned int> adjacent;
+	std::vector<Collapse> collapses;
+	double largestError = 0.0;
+
+	// Each pass collapses the cheapest edges that do not share a vertex, then rebuilds the triangle list
+	while (output.size() > targetIndexCount) {
+		edges.clear();
+		for (size_t t = 0; t + 2 < output.size(); t += 3) {
+			for (int e = 0; e < 3; e++) {
+				unsigned int a = output[t + e], b = output[t + (e + 1) % 3];
+				edges.push_back((unsigned long long)std::min(a, b) << 32 | std::max(a, b));
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+		// Each edge collapses in whichever direction is allowed and cheaper
+		collapses.clear();
+		for (size_t i = 0; i < edges.size(); i++) {
+			unsigned int a = (unsigned int)(edges[i] >> 32), b = (unsigned int)edges[i];
+			Quadric sum = quadrics[a];
+			addQuadric(sum, quadrics[b]);
+			Collapse collapse = { a, b, 0.0f };
+			float errorAtB = locked[a] ? -1.0f : (float)quadricError(sum, &scaled[b * 3]);
+			float errorAtA = locked[b] ? -1.0f : (float)quadricError(sum, &scaled[a * 3]);
+			if (errorAtB < 0.0f && errorAtA < 0.0f) {
+				continue;
+			}
+			if (errorAtB < 0.0f || (errorAtA >= 0.0f && errorAtA < errorAtB)) {
+				collapse.from = b;
+				collapse.to = a;
+				collapse.error = errorAtA;
+			}
+			else {
+				collapse.error = errorAtB;
+			}
+			collapses.push_back(collapse);
+		}
+		if (collapses.empty()) {
+			break;
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse &x, const Collapse &y) {
+			return x.error < y.error;
+		});
+
+		// A collapse removes about two triangles. Collapses sharing a vertex have to wait for the next pass, so the
+		// search reaches past the goal-th cheapest, but not so far that dear collapses jump ahead of deferred ones
+		size_t goal = (output.size() - targetIndexCount) / 6 + 1;
+		float errorLimit = collapses[std::min(goal * 2, collapses.size()) - 1].error;
+
+		// Triangles around each vertex, for the flip test
+		std::fill(firstAdjacent.begin(), firstAdjacent.end(), 0);
+		for (size_t i = 0; i < output.size(); i++) {
+			firstAdjacent[output[i] + 1]++;
+		}
+		for (size_t v = 0; v < vertexCount; v++) {
+			firstAdjacent[v + 1] += firstAdjacent[v];
+		}
+		adjacent.resize(output.size());
+		std::vector<unsigned int> filled(firstAdjacent.begin(), firstAdjacent.end() - 1);
+		for (size_t i = 0; i < output.size(); i++) {
+			adjacent[filled[output[i]]++] = (unsigned int)(i / 3 * 3);
+		}
+
+		for (size_t v = 0; v < vertexCount; v++) {
+			remap[v] = (unsigned int)v;
+		}
+		std::fill(touched.begin(), touched.end(), false);
+		size_t collapsed = 0;
+		for (size_t i = 0; i < collapses.size() && collapsed < goal; i++) {
+			const Collapse &collapse = collapses[i];
+			if (collapse.error > errorLimit) {
+				break;
+			}
+			if (touched[collapse.from] || touched[collapse.to]) {
+				continue;
+			}
+
+			// Reject the collapse if any triangle that survives it would turn over
+			bool flips = false;
+			for (unsigned int j = firstAdjacent[collapse.from]; j < firstAdjacent[collapse.from + 1] && !flips; j++) {
+				const unsigned int* triangle = &output[adjacent[j]];
+				unsigned int corners[3] = { remap[triangle[0]], remap[triangle[1]], remap[triangle[2]] };
+				if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to) {
+					continue;
+				}
+				float before[3], after[3];
+				for (int pass = 0; pass < 2; pass++) {
+					const float* p[3];
+					for (int c = 0; c < 3; c++) {
+						p[c] = &scaled[(pass == 1 && corners[c] == collapse.from ? collapse.to : corners[c]) * 3];
+					}
+					float e1[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+					float e2[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+					float* n = pass == 0 ? before : after;
+					n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+					n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+					n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+				}
+				// Triangles that already have no area, like the ones around a pole, cannot turn over
+				float beforeLength = before[0] * before[0] + before[1] * before[1] + before[2] * before[2];
+				float afterLength = after[0] * after[0] + after[1] * after[1] + after[2] * after[2];
+				float dot = before[0] * after[0] + before[1] * after[1] + before[2] * after[2];
+				flips = beforeLength > 0.0f && afterLength > 0.0f && dot <= 0.0f;
+			}
+			if (flips) {
+				continue;
+			}
+
+			remap[collapse.from] = collapse.to;
+			touched[collapse.from] = true;
+			touched[collapse.to] = true;
+			addQuadric(quadrics[collapse.to], quadrics[collapse.from]);
+			largestError = std::max(largestError, (double)collapse.error);
+			collapsed++;
+		}
+		if (collapsed == 0) {
+			break;
+		}
+
+		// Move the collapsed corners and drop the triangles that became degenerate
+		size_t write = 0;
+		for (size_t t = 0; t + 2 < output.size(); t += 3) {
+			unsigned int a = remap[output[t]], b = remap[output[t + 1]], c = remap[output[t + 2]];
+			if (a != b && b != c && a != c) {
+				output[write++] = a;
+				output[write++] = b;
+				output[write++] = c;
+			}
+		}
+		output.resize(write);
+	}
+	return (float)std::sqrt(largestError);
+}
@@ -0,0 +1,26 @@
+/*
+ * MeshSimplifier.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Quadric error metric simplification by collapsing edges onto existing vertices
+ */
+
+#ifndef MESHSIMPLIFIER_HPP
+#define MESHSIMPLIFIER_HPP
+
+#include <cstddef>
+#include <vector>
+
+class MeshSimplifier {
+public:
+	// Collapse edges of a triangle list, cheapest quadric error first, until at most targetIndexCount indices
+	// are left or no collapse is possible. Vertices only move onto other vertices, so the output indexes the
+	// same vertex buffer. Attribute seams, where vertices share a position, and open borders are kept in
+	// place. Returns the largest error introduced, as a distance relative to the mesh's extent.
+	// positionStride is in bytes
+	static float simplify(const std::vector<unsigned int> &indices, const float* positions, size_t positionStride,
+		size_t vertexCount, size_t targetIndexCount, std::vector<unsigned int> &output);
+};
+
+#endif
@@ -0,0 +1,410 @@
+/*
+ * ObjLoader.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Memory-mapped Wavefront OBJ loading into deduplicated, cache-ordered indexed meshes
+ */
+
+#include "ObjLoader.hpp"
+#include "ShaderSource.hpp"
+#include "MeshOptimizer.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+typedef std::chrono::high_resolution_clock LoadClock;
+
+// Position, texture coordinate and normal indices of one face corner, -1 where the face leaves one out
+struct ObjCorner {
+	int position;
+	int texCoord;
+	int normal;
+};
+
+// Powers of ten that doubles hold exactly, enough for the digits OBJ exporters write
+static const double POWERS_OF_TEN[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Helper function to step over spaces and tabs, stopping at the end of the line
+static void skipSpaces(const char* &p, const char* end) {
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+		p++;
+	}
+}
+
+// Helper function to read a decimal number with an optional fraction and exponent, straight from the mapping
+static bool parseFloat(const char* &p, const char* end, float &value) {
+	skipSpaces(p, end);
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+')) {
+		negative = *p == '-';
+		p++;
+	}
+	unsigned long long mantissa = 0;
+	int exponent = 0, digits = 0;
+	for (; p < end && *p >= '0' && *p <= '9'; p++, digits++) {
+		// Digits past what the mantissa holds only scale it
+		if (mantissa < 100000000000000000ull) {
+			mantissa = mantissa * 10 + (*p - '0');
+		}
+		else {
+			exponent++;
+		}
+	}
+	if (p < end && *p == '.') {
+		for (p++; p < end && *p >= '0' && *p <= '9'; p++, digits++) {
+			if (mantissa < 100000000000000000ull) {
+				mantissa = mantissa * 10 + (*p - '0');
+				exponent--;
+			}
+		}
+	}
+	if (digits == 0) {
+		return false;
+	}
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		p++;
+		bool negativeExponent = false;
+		if (p < end && (*p == '-' || *p == '+')) {
+			negativeExponent = *p == '-';
+			p++;
+		}
+		int power = 0;
+		for (; p < end && *p >= '0' && *p <= '9'; p++) {
+			power = power * 10 + (*p - '0');
+		}
+		exponent += negativeExponent ? -power : power;
+	}
+	double result = (double)mantissa;
+	if (exponent < 0) {
+		result = -exponent <= 22 ? result / POWERS_OF_TEN[-exponent] : result * std::pow(10.0, exponent);
+	}
+	else if (exponent > 0) {
+		result = exponent <= 22 ? result * POWERS_OF_TEN[exponent] : result * std::pow(10.0, exponent);
+	}
+	value = (float)(negative ? -result : result);
+	return true;
+}
+
+// Helper function to read a possibly negative integer, straight from the mapping
+static bool parseInt(const char* &p, const char* end, int &value) {
+	bool negative = false;
+	if (p < end && *p == '-') {
+		negative = true;
+		p++;
+	}
+	if (p == end || *p < '0' || *p > '9') {
+		return false;
+	}
+	int result = 0;
+	for (; p < end && *p >= '0' && *p <= '9'; p++) {
+		result = result * 10 + (*p - '0');
+	}
+	value = negative ? -result : result;
+	return true;
+}
+
+// Helper function to turn a 1-based or negative relative OBJ index into a 0-based one, -1 if it is out of range
+static int resolveIndex(int index, size_t count) {
+	int resolved = index < 0 ? (int)count + index : index - 1;
+	return resolved >= 0 && resolved < (int)count ? resolved : -1;
+}
+
+// Helper function to hash a corner's indices for the deduplication table
+static unsigned int hashCorner(const ObjCorner &corner) {
+	unsigned int h = (unsigned int)corner.position * 73856093u ^ (unsigned int)corner.texCoord * 19349663u
+		^ (unsigned int)corner.normal * 83492791u;
+	h ^= h >> 16;
+	h *= 0x85EBCA6Bu;
+	h ^= h >> 13;
+	return h;
+}
+
+// Constructor starts with an empty mesh
+ObjMesh::ObjMesh() {
+	std::memset(&stats, 0, sizeof(stats));
+}
+
+// Map and parse an OBJ file, fan its polygons into triangles and merge corners with the same position,
+// texture coordinate and normal. The triangles are then reordered for the vertex cache and overdraw
+// unless optimize is false. False with an error printed if the file cannot be read or has no faces
+bool ObjMesh::load(const std::string &path, bool optimize) {
+	vertices.clear();
+	indices.clear();
+	std::memset(&stats, 0, sizeof(stats));
+	LoadClock::time_point start = LoadClock::now();
+
+	MappedFile file;
+	std::string error;
+	if (!file.open(path, error)) {
+		std::cout << "Error: " << error << std::endl;
+		return false;
+	}
+	const char* p = file.data();
+	const char* end = p + file.size();
+
+	// Positions carry an optional w and color after them, as some exporters write
+	std::vector<float> positions, colors, texCoords, normals;
+	std::vector<ObjCorner> corners;
+	int line = 1;
+	while (p < end) {
+		skipSpaces(p, end);
+		const char* keyword = p;
+		while (p < end && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') {
+			p++;
+		}
+		size_t keywordLength = p - keyword;
+		bool valid = true;
+
+		if (keywordLength == 1 && keyword[0] == 'v') {
+			// x y z, x y z w, x y z r g b or x y z w r g b
+			float values[8];
+			int count = 0;
+			while (count < 8 && parseFloat(p, end, values[count])) {
+				count++;
+			}
+			valid = count == 3 || count == 4 || count == 6 || count == 7;
+			float x = 0.0f, y = 0.0f, z = 0.0f, r = 1.0f, g = 1.0f, b = 1.0f;
+			if (valid) {
+				// A homogeneous w scales the point, 0 would put it at infinity and is left alone
+				float w = count == 4 || count == 7 ? values[3] : 1.0f;
+				float scale = w != 0.0f ? 1.0f / w : 1.0f;
+				x = values[0] * scale;
+				y = values[1] * scale;
+				z = values[2] * scale;
+				if (count >= 6) {
+					r = values[count - 3];
+					g = values[count - 2];
+					b = values[count - 1];
+				}
+			}
+			positions.push_back(x);
+			positions.push_back(y);
+			positions.push_back(z);
+			colors.push_back(r);
+			colors.push_back(g);
+			colors.push_back(b);
+		}
+		else if (keywordLength == 2 && keyword[0] == 'v' && keyword[1] == 't') {
+			float u = 0.0f, v = 0.0f;
+			valid = parseFloat(p, end, u);
+			parseFloat(p, end, v);
+			texCoords.push_back(u);
+			texCoords.push_back(v);
+		}
+		else if (keywordLength == 2 && keyword[0] == 'v' && keyword[1] == 'n') {
+			float x = 0.0f, y = 0.0f, z = 0.0f;
+			valid = parseFloat(p, end, x) && parseFloat(p, end, y) && parseFloat(p, end, z);
+			normals.push_back(x);
+			normals.push_back(y);
+			normals.push_back(z);
+		}
+		else if (keywordLength == 1 && keyword[0] == 'f') {
+			// Polygons are fanned out from their first corner
+			ObjCorner first = { -1, -1, -1 }, previous = { -1, -1, -1 };
+			int count = 0;
+			for (;;) {
+				skipSpaces(p, end);
+				ObjCorner corner = { -1, -1, -1 };
+				int index;
+				if (!parseInt(p, end, index)) {
+					break;
+				}
+				corner.position = resolveIndex(index, positions.size() / 3);
+				if (p < end && *p == '/') {
+					p++;
+					if (parseInt(p, end, index)) {
+						corner.texCoord = resolveIndex(index, texCoords.size() / 2);
+					}
+					if (p < end && *p == '/') {
+						p++;
+						if (parseInt(p, end, index)) {
+							corner.normal = resolveIndex(index, normals.size() / 3);
+						}
+					}
+				}
+				if (corner.position == -1) {
+					valid = false;
+					break;
+				}
+				if (count == 0) {
+					first = corner;
+				}
+				else if (count >= 2) {
+					corners.push_back(first);
+					corners.push_back(previous);
+					corners.push_back(corner);
+				}
+				previous = corner;
+				count++;
+			}
+			valid = valid && count >= 3;
+		}
+
+		if (!valid) {
+			std::cout << "Error: " << path << " line " << line << " is malformed" << std::endl;
+			return false;
+		}
+		// Anything else, comments, groups, materials and smoothing groups included, is skipped
+		while (p < end && *p != '\n') {
+			p++;
+		}
+		if (p < end) {
+			p++;
+		}
+		line++;
+	}
+	if (corners.empty()) {
+		std::cout << "Error: " << path << " has no faces" << std::endl;
+		return false;
+	}
+
+	// Open addressing table from corner to vertex, at most half full
+	size_t tableSize = 1;
+	while (tableSize < corners.size() * 2) {
+		tableSize <<= 1;
+	}
+	const unsigned int EMPTY = 0xFFFFFFFFu;
+	std::vector<unsigned int> table(tableSize, EMPTY);
+	std::vector<ObjCorner> unique;
+	indices.reserve(corners.size());
+	for (size_t i = 0; i < corners.size(); i++) {
+		const ObjCorner &corner = corners[i];
+		size_t slot = hashCorner(corner) & (tableSize - 1);
+		while (table[slot] != EMPTY) {
+			const ObjCorner &other = unique[table[slot]];
+			if (other.position == corner.position && other.texCoord == corner.texCoord && other.normal == corner.normal) {
+				break;
+			}
+			slot = (slot + 1) & (tableSize - 1);
+		}
+		if (table[slot] == EMPTY) {
+			table[slot] = (unsigned int)unique.size();
+			unique.push_back(corner);
+		}
+		indices.push_back(table[slot]);
+	}
+
+	vertices.resize(unique.size());
+	bool missingNormals = false;
+	for (size_t i = 0; i < unique.size(); i++) {
+		MeshVertex &vertex = vertices[i];
+		const ObjCorner &corner = unique[i];
+		std::memcpy(vertex.position, &positions[corner.position * 3], sizeof(vertex.position));
+		std::memcpy(vertex.color, &colors[corner.position * 3], sizeof(vertex.color));
+		vertex.texCoord[0] = corner.texCoord >= 0 ? texCoords[corner.texCoord * 2] : 0.0f;
+		vertex.texCoord[1] = corner.texCoord >= 0 ? texCoords[corner.texCoord * 2 + 1] : 0.0f;
+		if (corner.normal >= 0) {
+			std::memcpy(vertex.normal, &normals[corner.normal * 3], sizeof(vertex.normal));
+		}
+		else {
+			vertex.normal[0] = vertex.normal[1] = vertex.normal[2] = 0.0f;
+			missingNormals = true;
+		}
+	}
+
+	// Corners without a normal get the area weighted average of the faces around them
+	if (missingNormals) {
+		for (size_t t = 0; t < indices.size(); t += 3) {
+			const float* p0 = vertices[indices[t]].position;
+			const float* p1 = vertices[indices[t + 1]].position;
+			const float* p2 = vertices[indices[t + 2]].position;
+			float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+			float e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			float normal[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			for (int c = 0; c < 3; c++) {
+				if (unique[indices[t + c]].normal < 0) {
+					float* target = vertices[indices[t + c]].normal;
+					target[0] += normal[0];
+					target[1] += normal[1];
+					target[2] += normal[2];
+				}
+			}
+		}
+		for (size_t i = 0; i < vertices.size(); i++) {
+			if (unique[i].normal < 0) {
+				float* normal = vertices[i].normal;
+				float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+				if (length > 0.0f) {
+					normal[0] /= length;
+					normal[1] /= length;
+					normal[2] /= length;
+				}
+			}
+		}
+	}
+
+	stats.bytes = file.size();
+	stats.corners = corners.size();
+	stats.vertices = vertices.size();
+	stats.triangles = indices.size() / 3;
+	stats.parseMs = std::chrono::duration<double, std::milli>(LoadClock::now() - start).count();
+	stats.loadedMissRatio = MeshOptimizer::averageCacheMissRatio(indices, vertices.size());
+	stats.cacheMissRatio = stats.loadedMissRatio;
+	stats.overdrawMissRatio = stats.loadedMissRatio;
+	if (!optimize) {
+		return true;
+	}
+
+	start = LoadClock::now();
+	MeshOptimizer::optimizeVertexCache(indices, vertices.size());
+	stats.cacheMissRatio = MeshOptimizer::averageCacheMissRatio(indices, vertices.size());
+	MeshOptimizer::optimizeOverdraw(indices, vertices[0].position, sizeof(MeshVertex), vertices.size());
+	stats.overdrawMissRatio = MeshOptimizer::averageCacheMissRatio(indices, vertices.size());
+
+	// Store the vertices in the order the triangles fetch them
+	std::vector<unsigned int> remap;
+	MeshOptimizer::optimizeVertexFetch(indices, vertices.size(), remap);
+	std::vector<MeshVertex> ordered(remap.size());
+	for (size_t i = 0; i < remap.size(); i++) {
+		ordered[i] = vertices[remap[i]];
+	}
+	vertices.swap(ordered);
+	stats.vertices = vertices.size();
+	stats.optimizeMs = std::chrono::duration<double, std::milli>(LoadClock::now() - start).count();
+	return true;
+}
+
+// Layout of MeshVertex at the quad's attribute locations, with the normal at location 6
+VertexFormat ObjMesh::getFormat() {
+	VertexFormat format;
+	format.add(0, 3, VertexFormat::FLOAT32).add(1, 3, VertexFormat::FLOAT32)
+		.add(2, 2, VertexFormat::FLOAT32).add(6, 3, VertexFormat::FLOAT32);
+	return format;
+}
+
+// Upload into a new vertex array, the index buffer picking its type or splitting the mesh as it sees fit
+unsigned int ObjMesh::createVertexArray(IndexBuffer &indexBuffer, unsigned int &vertexBuffer) const {
+	unsigned int vertexArray;
+	glGenVertexArrays(1, &vertexArray);
+	std::vector<unsigned int> remap;
+	indexBuffer.uploadTriangles(vertexArray, indices, vertices.size(), sizeof(MeshVertex), remap);
+
+	const unsigned char* data = (const unsigned char*)vertices.data();
+	size_t size = vertices.size() * sizeof(MeshVertex);
+	std::vector<unsigned char> remapped;
+	if (!remap.empty()) {
+		IndexBuffer::remapVertices(data, sizeof(MeshVertex), remap, remapped);
+		data = remapped.data();
+		size = remapped.size();
+	}
+	glGenBuffers(1, &vertexBuffer);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+	getFormat().apply(vertexArray, vertexBuffer);
+	return vertexArray;
+}
+
+// Print sizes, load throughput and the cache miss ratios before and after optimizing
+void ObjMesh::printReport(const std::string &name) const {
+	std::cout << "Mesh " << name << ": " << stats.triangles << " triangles, " << stats.corners << " corners merged into "
+		<< stats.vertices << " vertices" << std::endl;
+	std::cout << "  parsed " << stats.bytes / (1024.0 * 1024.0) << " MB in " << stats.parseMs << " ms ("
+		<< stats.bytes / (1024.0 * 1024.0) / (stats.parseMs / 1000.0) << " MB/s), optimized in " << stats.optimizeMs << " ms" << std::endl;
+	std::cout << "  ACMR " << stats.loadedMissRatio << " as loaded, " << stats.cacheMissRatio << " after cache ordering, "
+		<< stats.overdrawMissRatio << " after overdraw ordering" << std::endl;
+}
@@ -0,0 +1,67 @@
+/*
+ * ObjLoader.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Memory-mapped Wavefront OBJ loading into deduplicated, cache-ordered indexed meshes
+ */
+
+#ifndef OBJLOADER_HPP
+#define OBJLOADER_HPP
+
+#include <GL/glew.h>
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "GLState.hpp"
+#include "VertexFormat.hpp"
+#include "IndexBuffer.hpp"
+
+// One interleaved vertex, laid out like the quad with a normal added on the end
+struct MeshVertex {
+	float position[3];
+	float color[3];
+	float texCoord[2];
+	float normal[3];
+};
+
+// Sizes and timings of the last load, cache miss ratios are vertices transformed per triangle
+struct ObjLoadStats {
+	size_t bytes;
+	size_t corners;
+	size_t vertices;
+	size_t triangles;
+	double parseMs;
+	double optimizeMs;
+	float loadedMissRatio;
+	float cacheMissRatio;
+	float overdrawMissRatio;
+};
+
+class ObjMesh {
+public:
+	// Constructor starts with an empty mesh
+	ObjMesh();
+
+	// Map and parse an OBJ file, fan its polygons into triangles and merge corners with the same position,
+	// texture coordinate and normal. The triangles are then reordered for the vertex cache and overdraw
+	// unless optimize is false. False with an error printed if the file cannot be read or has no faces
+	bool load(const std::string &path, bool optimize = true);
+
+	// Layout of MeshVertex at the quad's attribute locations, with the normal at location 6
+	static VertexFormat getFormat();
+
+	// Upload into a new vertex array, the index buffer picking its type or splitting the mesh as it sees fit
+	unsigned int createVertexArray(IndexBuffer &indexBuffer, unsigned int &vertexBuffer) const;
+
+	// Print sizes, load throughput and the cache miss ratios before and after optimizing
+	void printReport(const std::string &name) const;
+
+	std::vector<MeshVertex> vertices;
+	std::vector<unsigned int> indices;
+	ObjLoadStats stats;
+};
+
+#endif
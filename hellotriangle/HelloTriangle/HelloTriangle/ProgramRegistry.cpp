@@ -0,0 +1,207 @@
+/*
+ * ProgramRegistry.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Shared, reference-counted shader programs deduplicated by source paths and content
+ */
+
+#include "ProgramRegistry.hpp"
+
+#include <algorithm>
+
+// Empty handle that refers to no program
+ProgramHandle::ProgramHandle() : registry(NULL), entry(NULL) {
+}
+
+// Only the registry creates handles to its entries
+ProgramHandle::ProgramHandle(ProgramRegistry* registry, ProgramEntry* entry) : registry(registry), entry(entry) {
+	entry->references++;
+}
+
+// Copies share the program and add a reference
+ProgramHandle::ProgramHandle(const ProgramHandle &other) : registry(other.registry), entry(other.entry) {
+	if (entry != NULL) {
+		entry->references++;
+	}
+}
+
+ProgramHandle &ProgramHandle::operator=(const ProgramHandle &other) {
+	// Take the new reference first so assigning a handle to itself is safe
+	if (other.entry != NULL) {
+		other.entry->references++;
+	}
+	release();
+	registry = other.registry;
+	entry = other.entry;
+	return *this;
+}
+
+// Destructor releases the reference
+ProgramHandle::~ProgramHandle() {
+	release();
+}
+
+// Drop this reference early, deleting the program if it was the last one
+void ProgramHandle::release() {
+	if (entry != NULL) {
+		registry->release(entry);
+	}
+	registry = NULL;
+	entry = NULL;
+}
+
+// True if the handle refers to a program
+bool ProgramHandle::valid() const {
+	return entry != NULL;
+}
+
+// Access the shared shader
+BaseShader* ProgramHandle::operator->() const {
+	return entry->shader.get();
+}
+
+BaseShader &ProgramHandle::operator*() const {
+	return *entry->shader;
+}
+
+BaseShader* ProgramHandle::get() const {
+	return entry == NULL ? NULL : entry->shader.get();
+}
+
+// Constructor takes the binary cache and watcher shared by every program it builds, either may be NULL
+ProgramRegistry::ProgramRegistry(ProgramBinaryCache* cache, ShaderWatcher* watcher)
+	: cache(cache), watcher(watcher), requests(0), shared(0) {
+}
+
+// Destructor deletes any program that is still referenced
+ProgramRegistry::~ProgramRegistry() {
+	for (std::unordered_map<unsigned long long, ProgramEntry*>::iterator it = entries.begin(); it != entries.end(); ++it) {
+		if (watcher != NULL) {
+			watcher->unwatch(it->second->shader.get());
+		}
+		delete it->second;
+	}
+	for (size_t i = 0; i < unlisted.size(); i++) {
+		if (watcher != NULL) {
+			watcher->unwatch(unlisted[i]->shader.get());
+		}
+		delete unlisted[i];
+	}
+}
+
+// Program for the sources and defines, built only if no identical program is alive
+ProgramHandle ProgramRegistry::acquire(const char* vertexPath, const char* fragmentPath, const ShaderDefines &defines,
+	BaseShader::BuildMode mode) {
+	// Reading and hashing the sources is far cheaper than the compile it may avoid
+	ShaderSource vertexSource, fragmentSource;
+	if (!preprocessShader(vertexPath, defines, vertexSource) || !preprocessShader(fragmentPath, defines, fragmentSource)) {
+		// Let the shader report the failure, keyed by path since there is no content to hash
+		unsigned long long key = ProgramBinaryCache::hashText(std::string(vertexPath) + "\n" + fragmentPath + "\n" + defines.toString());
+		return acquireKey(key, vertexPath, fragmentPath, defines, NULL, NULL, mode);
+	}
+	return acquire(vertexPath, fragmentPath, defines, vertexSource, fragmentSource, mode);
+}
+
+// Same as acquire, for sources that were already preprocessed
+ProgramHandle ProgramRegistry::acquire(const char* vertexPath, const char* fragmentPath, const ShaderDefines &defines,
+	const ShaderSource &vertexSource, const ShaderSource &fragmentSource, BaseShader::BuildMode mode) {
+	// The defines are already part of the preprocessed text, so the paths and stage contents identify the program.
+	// The paths keep identical files apart, since each program watches and reloads its own
+	unsigned long long key = makeKey(vertexPath, fragmentPath, vertexSource.hash(), fragmentSource.hash());
+	return acquireKey(key, vertexPath, fragmentPath, defines, &vertexSource, &fragmentSource, mode);
+}
+
+// Number of distinct programs alive
+size_t ProgramRegistry::size() const {
+	return entries.size();
+}
+
+// Print how many requests were served by an existing program
+void ProgramRegistry::printReport() const {
+	std::cout << "Program registry: " << requests << " requests, " << shared << " shared, "
+		<< entries.size() << " programs alive" << std::endl;
+}
+
+// Helper function to drop one reference, deleting the program with the last one
+void ProgramRegistry::release(ProgramEntry* entry) {
+	if (--entry->references > 0) {
+		return;
+	}
+	if (watcher != NULL) {
+		watcher->unwatch(entry->shader.get());
+	}
+	std::vector<ProgramEntry*>::iterator it = std::find(unlisted.begin(), unlisted.end(), entry);
+	if (it != unlisted.end()) {
+		unlisted.erase(it);
+	}
+	else {
+		entries.erase(entry->key);
+	}
+	delete entry;
+}
+
+// Helper function to combine the source paths and the hash of each stage into a key
+unsigned long long ProgramRegistry::makeKey(const std::string &vertexPath, const std::string &fragmentPath,
+	unsigned long long vertexHash, unsigned long long fragmentHash) {
+	unsigned long long key = ProgramBinaryCache::hashText(vertexPath + "\n" + fragmentPath + "\n");
+	key = ProgramBinaryCache::hashBytes((const char*)&vertexHash, sizeof(vertexHash), key);
+	return ProgramBinaryCache::hashBytes((const char*)&fragmentHash, sizeof(fragmentHash), key);
+}
+
+// Helper function to move programs swapped by a hot reload to the key of the sources they now run
+void ProgramRegistry::rekeyReloaded() {
+	std::vector<ProgramEntry*> moved;
+	for (std::unordered_map<unsigned long long, ProgramEntry*>::iterator it = entries.begin(); it != entries.end(); ++it) {
+		const ProgramTiming &timing = it->second->shader->getBuildTiming();
+		if (!timing.reload) {
+			continue;
+		}
+		unsigned long long key = makeKey(it->second->shader->getVertexPath(), it->second->shader->getFragmentPath(),
+			timing.vertex.sourceHash, timing.fragment.sourceHash);
+		if (key != it->first) {
+			moved.push_back(it->second);
+		}
+	}
+	for (size_t i = 0; i < moved.size(); i++) {
+		entries.erase(moved[i]->key);
+	}
+	for (size_t i = 0; i < moved.size(); i++) {
+		const ProgramTiming &timing = moved[i]->shader->getBuildTiming();
+		moved[i]->key = makeKey(moved[i]->shader->getVertexPath(), moved[i]->shader->getFragmentPath(),
+			timing.vertex.sourceHash, timing.fragment.sourceHash);
+		// A program edited into the same sources as another stays alive for its handles, but is no longer shared
+		if (!entries.insert(std::make_pair(moved[i]->key, moved[i])).second) {
+			unlisted.push_back(moved[i]);
+		}
+	}
+}
+
+// Helper function to look up or build the program for a content key
+ProgramHandle ProgramRegistry::acquireKey(unsigned long long key, const char* vertexPath, const char* fragmentPath,
+	const ShaderDefines &defines, const ShaderSource* vertexSource, const ShaderSource* fragmentSource,
+	BaseShader::BuildMode mode) {
+	requests++;
+	// A program edited since it was registered is found under the key of its new sources
+	rekeyReloaded();
+	std::unordered_map<unsigned long long, ProgramEntry*>::iterator it = entries.find(key);
+	if (it != entries.end()) {
+		shared++;
+		return ProgramHandle(this, it->second);
+	}
+
+	ProgramEntry* entry = new ProgramEntry();
+	entry->key = key;
+	entry->references = 0;
+	if (vertexSource != NULL && fragmentSource != NULL) {
+		entry->shader.reset(new BaseShader(vertexPath, fragmentPath, defines, *vertexSource, *fragmentSource, cache, mode));
+	}
+	else {
+		entry->shader.reset(new BaseShader(vertexPath, fragmentPath, defines, cache, mode));
+	}
+	entries[key] = entry;
+	if (watcher != NULL) {
+		watcher->watch(entry->shader.get());
+	}
+	return ProgramHandle(this, entry);
+}
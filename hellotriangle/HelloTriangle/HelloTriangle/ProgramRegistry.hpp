@@ -0,0 +1,114 @@
+/*
+ * ProgramRegistry.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Shared, reference-counted shader programs deduplicated by source paths and content
+ */
+
+#ifndef PROGRAMREGISTRY_HPP
+#define PROGRAMREGISTRY_HPP
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "BaseShader.hpp"
+#include "ShaderWatcher.hpp"
+
+class ProgramRegistry;
+
+// Program shared by everyone who acquired the same source files, contents and defines
+struct ProgramEntry {
+	unsigned long long key;
+	int references;
+	std::unique_ptr<BaseShader> shader;
+};
+
+// Reference to a registered program, released when the last copy goes away
+class ProgramHandle {
+public:
+	// Empty handle that refers to no program
+	ProgramHandle();
+
+	// Copies share the program and add a reference
+	ProgramHandle(const ProgramHandle &other);
+	ProgramHandle &operator=(const ProgramHandle &other);
+
+	// Destructor releases the reference
+	~ProgramHandle();
+
+	// Drop this reference early, deleting the program if it was the last one
+	void release();
+
+	// True if the handle refers to a program
+	bool valid() const;
+
+	// Access the shared shader
+	BaseShader* operator->() const;
+	BaseShader &operator*() const;
+	BaseShader* get() const;
+
+private:
+	friend class ProgramRegistry;
+
+	// Only the registry creates handles to its entries
+	ProgramHandle(ProgramRegistry* registry, ProgramEntry* entry);
+
+	ProgramRegistry* registry;
+	ProgramEntry* entry;
+};
+
+class ProgramRegistry {
+public:
+	// Constructor takes the binary cache and watcher shared by every program it builds, either may be NULL
+	ProgramRegistry(ProgramBinaryCache* cache = NULL, ShaderWatcher* watcher = NULL);
+
+	// Destructor deletes any program that is still referenced
+	~ProgramRegistry();
+
+	// Program for the sources and defines, built only if no identical program is alive
+	ProgramHandle acquire(const char* vertexPath, const char* fragmentPath, const ShaderDefines &defines = ShaderDefines(),
+		BaseShader::BuildMode mode = BaseShader::BUILD_BLOCKING);
+
+	// Same as acquire, for sources that were already preprocessed
+	ProgramHandle acquire(const char* vertexPath, const char* fragmentPath, const ShaderDefines &defines,
+		const ShaderSource &vertexSource, const ShaderSource &fragmentSource,
+		BaseShader::BuildMode mode = BaseShader::BUILD_BLOCKING);
+
+	// Number of distinct programs alive
+	size_t size() const;
+
+	// Print how many requests were served by an existing program
+	void printReport() const;
+
+private:
+	friend class ProgramHandle;
+
+	ProgramBinaryCache* cache;
+	ShaderWatcher* watcher;
+	std::unordered_map<unsigned long long, ProgramEntry*> entries;
+	// Programs whose reload made them identical to another one, alive until released but not found by acquire
+	std::vector<ProgramEntry*> unlisted;
+
+	int requests;
+	int shared;
+
+	// Helper function to drop one reference, deleting the program with the last one
+	void release(ProgramEntry* entry);
+
+	// Helper function to combine the source paths and the hash of each stage into a key
+	static unsigned long long makeKey(const std::string &vertexPath, const std::string &fragmentPath,
+		unsigned long long vertexHash, unsigned long long fragmentHash);
+
+	// Helper function to move programs swapped by a hot reload to the key of the sources they now run
+	void rekeyReloaded();
+
+	// Helper function to look up or build the program for a content key
+	ProgramHandle acquireKey(unsigned long long key, const char* vertexPath, const char* fragmentPath,
+		const ShaderDefines &defines, const ShaderSource* vertexSource, const ShaderSource* fragmentSource,
+		BaseShader::BuildMode mode);
+};
+
+#endif
@@ -0,0 +1,207 @@
+/*
+ * RenderQueue.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Draws queued with a 64-bit sort key, radix sorted so submission switches program, textures and vertex arrays as
+ * rarely as possible
+ */
+
+#include "RenderQueue.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// Bits given to each field of the key
+static const int LAYER_BITS = 4;
+static const int PROGRAM_BITS = 10;
+static const int TEXTURE_SET_BITS = 12;
+static const int VERTEX_ARRAY_BITS = 12;
+static const int DEPTH_BITS = 24;
+
+// Constructor starts with an empty queue and no state names seen
+RenderQueue::RenderQueue() : frames(0) {
+	resetStats();
+}
+
+// Helper function to find or assign the id of a state name, clamped to the bits it gets in a key
+template <typename T>
+unsigned long long RenderQueue::stateId(std::vector<T> &names, T name, int bits) {
+	size_t id = 0;
+	while (id < names.size() && names[id] != name) {
+		id++;
+	}
+	if (id == names.size()) {
+		names.push_back(name);
+	}
+	// Past the limit names share the last id, they still draw correctly but are no longer grouped
+	unsigned long long limit = (1ull << bits) - 1;
+	return id < limit ? id : limit;
+}
+
+// Pack an item into its key. From the top: 4 bits layer, 1 bit translucency, then program, texture set and
+// vertex array ids of 10, 12 and 12 bits with 24 bits of depth for opaque draws. Translucent draws move the
+// depth, inverted, ahead of the state so they blend back to front
+unsigned long long RenderQueue::makeKey(const RenderItem &item) {
+	unsigned long long program = stateId(programs, item.program, PROGRAM_BITS);
+	unsigned long long textureSet = stateId(textureSets,
+		((unsigned long long)item.textures[0] << 32) | item.textures[1], TEXTURE_SET_BITS);
+	unsigned long long vertexArray = stateId(vertexArrays, item.vertexArray, VERTEX_ARRAY_BITS);
+
+	float depth = item.depth < 0.0f ? 0.0f : (item.depth > 1.0f ? 1.0f : item.depth);
+	unsigned long long depthMax = (1ull << DEPTH_BITS) - 1;
+	unsigned long long quantized = (unsigned long long)(depth * depthMax);
+
+	unsigned long long layer = item.layer < (1u << LAYER_BITS) ? item.layer : (1u << LAYER_BITS) - 1;
+	unsigned long long key = layer << (64 - LAYER_BITS);
+	unsigned long long state = (program << (TEXTURE_SET_BITS + VERTEX_ARRAY_BITS)) | (textureSet << VERTEX_ARRAY_BITS)
+		| vertexArray;
+	if (item.translucent) {
+		key |= 1ull << (63 - LAYER_BITS);
+		key |= (depthMax - quantized) << (PROGRAM_BITS + TEXTURE_SET_BITS + VERTEX_ARRAY_BITS);
+		key |= state;
+	}
+	else {
+		key |= state << DEPTH_BITS;
+		key |= quantized;
+	}
+	return key;
+}
+
+// Empty the queue for the next frame, the ids given to state names are kept so keys stay stable
+void RenderQueue::clear() {
+	items.clear();
+	keys.clear();
+}
+
+// Queue a draw
+void RenderQueue::add(const RenderItem &item) {
+	items.push_back(item);
+	keys.push_back(makeKey(item));
+}
+
+// Sort the queued draws, then set each one's state through GLState and draw it
+void RenderQueue::submit(SortMode mode) {
+	// The keys are sorted as a copy, so the queue can be submitted again in either order
+	order.resize(items.size());
+	for (size_t i = 0; i < order.size(); i++) {
+		order[i] = (unsigned int)i;
+	}
+	if (mode == SORT_BY_KEY) {
+		sortedKeys = keys;
+		radixSort(sortedKeys, order, keyScratch, orderScratch);
+	}
+
+	GLStateStats before = GLState::getFrameStats();
+	for (size_t i = 0; i < order.size(); i++) {
+		const RenderItem &item = items[order[i]];
+		GLState::useProgram(item.program);
+		for (unsigned int unit = 0; unit < 2; unit++) {
+			if (item.textures[unit] != 0) {
+				GLState::bindTexture(unit, GL_TEXTURE_2D, item.textures[unit]);
+			}
+		}
+		GLState::bindVertexArray(item.vertexArray);
+		// Translucent draws blend over what is already there and leave the depth buffer as it is
+		GLState::setEnabled(GL_BLEND, item.translucent);
+		if (item.translucent) {
+			GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		}
+		GLState::depthMask(!item.translucent);
+
+		const void* offset = (const void*)item.indexOffset;
+		if (item.instanceCount > 1) {
+			glDrawElementsInstancedBaseVertex(item.mode, item.count, item.indexType, offset, item.instanceCount, item.baseVertex);
+		}
+		else {
+			glDrawElementsBaseVertex(item.mode, item.count, item.indexType, offset, item.baseVertex);
+		}
+	}
+	GLStateStats after = GLState::getFrameStats();
+
+	stats.draws += (unsigned int)items.size();
+	stats.programChanges += after.programChanges - before.programChanges;
+	stats.textureChanges += after.textureChanges - before.textureChanges;
+	stats.vertexArrayChanges += after.vertexArrayChanges - before.vertexArrayChanges;
+	frames++;
+}
+
+// Sort the keys in place with an 8 bit least significant digit radix sort, carrying the values along.
+// Digits every key shares are skipped
+void RenderQueue::radixSort(std::vector<unsigned long long> &keys, std::vector<unsigned int> &values,
+	std::vector<unsigned long long> &keyScratch, std::vector<unsigned int> &valueScratch) {
+	size_t count = keys.size();
+	if (count < 2) {
+		return;
+	}
+	keyScratch.resize(count);
+	valueScratch.resize(count);
+
+	// Counting every digit in one read of the keys leaves seven fewer passes over them
+	unsigned int histograms[8][256];
+	std::memset(histograms, 0, sizeof(histograms));
+	for (size_t i = 0; i < count; i++) {
+		unsigned long long key = keys[i];
+		for (int digit = 0; digit < 8; digit++) {
+			histograms[digit][(key >> (digit * 8)) & 0xFF]++;
+		}
+	}
+
+	unsigned long long* sourceKeys = keys.data();
+	unsigned int* sourceValues = values.data();
+	unsigned long long* destinationKeys = keyScratch.data();
+	unsigned int* destinationValues = valueScratch.data();
+	for (int digit = 0; digit < 8; digit++) {
+		unsigned int* histogram = histograms[digit];
+		int shift = digit * 8;
+		// Unused layers, a single program and the like leave whole digits the same in every key
+		if (histogram[(sourceKeys[0] >> shift) & 0xFF] == count) {
+			continue;
+		}
+		unsigned int offset = 0;
+		for (int bucket = 0; bucket < 256; bucket++) {
+			unsigned int bucketCount = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketCount;
+		}
+		for (size_t i = 0; i < count; i++) {
+			unsigned int position = histogram[(sourceKeys[i] >> shift) & 0xFF]++;
+			destinationKeys[position] = sourceKeys[i];
+			destinationValues[position] = sourceValues[i];
+		}
+		std::swap(sourceKeys, destinationKeys);
+		std::swap(sourceValues, destinationValues);
+	}
+
+	// An odd number of passes leaves the result in the scratch arrays
+	if (sourceKeys != keys.data()) {
+		keys.swap(keyScratch);
+		values.swap(valueScratch);
+	}
+}
+
+// Number of queued draws
+size_t RenderQueue::size() const {
+	return items.size();
+}
+
+// Draws and switches since the last reset
+RenderQueueStats RenderQueue::getStats() const {
+	return stats;
+}
+
+void RenderQueue::resetStats() {
+	stats.draws = 0;
+	stats.programChanges = 0;
+	stats.textureChanges = 0;
+	stats.vertexArrayChanges = 0;
+	frames = 0;
+}
+
+// Print the draws and switches per frame over the frames submitted since the last reset
+void RenderQueue::printReport(const std::string &name) const {
+	double perFrame = frames > 0 ? 1.0 / frames : 0.0;
+	std::cout << "Render queue " << name << ": " << stats.draws * perFrame << " draws, "
+		<< stats.programChanges * perFrame << " program, " << stats.textureChanges * perFrame << " texture and "
+		<< stats.vertexArrayChanges * perFrame << " vertex array changes per frame" << std::endl;
+}
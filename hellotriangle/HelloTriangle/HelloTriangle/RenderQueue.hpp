@@ -0,0 +1,108 @@
+/*
+ * RenderQueue.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Draws queued with a 64-bit sort key, radix sorted so submission switches program, textures and vertex arrays as
+ * rarely as possible
+ */
+
+#ifndef RENDERQUEUE_HPP
+#define RENDERQUEUE_HPP
+
+#include <GL/glew.h>
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "GLState.hpp"
+
+// One indexed draw and the state it needs. Textures are bound to units 0 and 1, a texture of 0 leaves the unit alone.
+// A program of 0 draws with whichever program pipeline is bound
+struct RenderItem {
+	unsigned int program;
+	unsigned int textures[2];
+	unsigned int vertexArray;
+	GLenum mode;
+	GLsizei count;
+	GLenum indexType;
+	size_t indexOffset;		// in bytes
+	int baseVertex;
+	GLsizei instanceCount;
+
+	// Layer 0 to 15 is drawn first to last, within a layer opaque draws come before translucent ones
+	unsigned int layer;
+	bool translucent;
+	// View depth from 0 at the near plane to 1 at the far plane, opaque draws go front to back and
+	// translucent ones back to front
+	float depth;
+};
+
+// Draws submitted and the state switches they caused since the last reset
+struct RenderQueueStats {
+	unsigned int draws;
+	unsigned int programChanges;
+	unsigned int textureChanges;
+	unsigned int vertexArrayChanges;
+};
+
+class RenderQueue {
+public:
+	// Sorting by key gives the fewest switches, submission order is kept for comparison
+	enum SortMode { SORT_BY_KEY, SORT_NONE };
+
+	// Constructor starts with an empty queue and no state names seen
+	RenderQueue();
+
+	// Pack an item into its key. From the top: 4 bits layer, 1 bit translucency, then program, texture set and
+	// vertex array ids of 10, 12 and 12 bits with 24 bits of depth for opaque draws. Translucent draws move the
+	// depth, inverted, ahead of the state so they blend back to front
+	unsigned long long makeKey(const RenderItem &item);
+
+	// Empty the queue for the next frame, the ids given to state names are kept so keys stay stable
+	void clear();
+
+	// Queue a draw
+	void add(const RenderItem &item);
+
+	// Sort the queued draws, then set each one's state through GLState and draw it
+	void submit(SortMode mode = SORT_BY_KEY);
+
+	// Sort the keys in place with an 8 bit least significant digit radix sort, carrying the values along.
+	// Digits every key shares are skipped
+	static void radixSort(std::vector<unsigned long long> &keys, std::vector<unsigned int> &values,
+		std::vector<unsigned long long> &keyScratch, std::vector<unsigned int> &valueScratch);
+
+	// Number of queued draws
+	size_t size() const;
+
+	// Draws and switches since the last reset
+	RenderQueueStats getStats() const;
+	void resetStats();
+
+	// Print the draws and switches per frame over the frames submitted since the last reset
+	void printReport(const std::string &name) const;
+
+private:
+	std::vector<RenderItem> items;
+	std::vector<unsigned long long> keys;
+	std::vector<unsigned int> order;
+	std::vector<unsigned long long> sortedKeys;
+	std::vector<unsigned long long> keyScratch;
+	std::vector<unsigned int> orderScratch;
+
+	// State names in the order first seen, their index is the id packed into keys
+	std::vector<unsigned int> programs;
+	std::vector<unsigned long long> textureSets;
+	std::vector<unsigned int> vertexArrays;
+
+	RenderQueueStats stats;
+	unsigned int frames;
+
+	// Helper function to find or assign the id of a state name, clamped to the bits it gets in a key
+	template <typename T>
+	static unsigned long long stateId(std::vector<T> &names, T name, int bits);
+};
+
+#endif
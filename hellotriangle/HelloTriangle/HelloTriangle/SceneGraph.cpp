@@ -0,0 +1,205 @@
+/*
+ * SceneGraph.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Transform hierarchy in flat arrays ordered parent before child, with world matrices updated lazily
+ */
+
+#include "SceneGraph.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Parent of a root node
+const int SceneGraph::NO_PARENT = -1;
+
+// No translation or rotation and a scale of 1
+NodeTransform NodeTransform::identity() {
+	NodeTransform transform = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 1.0f } };
+	return transform;
+}
+
+// Rotate by angle radians about the z axis, keeping the rest
+void NodeTransform::setRotationZ(float angle) {
+	rotation[0] = 0.0f;
+	rotation[1] = 0.0f;
+	rotation[2] = std::sin(angle * 0.5f);
+	rotation[3] = std::cos(angle * 0.5f);
+}
+
+// Helper function to build the matrix of a local transform, the rotation's columns scaled then translated
+static void composeLocal(const NodeTransform &local, WorldMatrix &matrix) {
+	float x = local.rotation[0], y = local.rotation[1], z = local.rotation[2], w = local.rotation[3];
+	float rotation[3][3] = {
+		{ 1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y - w * z), 2.0f * (x * z + w * y) },
+		{ 2.0f * (x * y + w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z - w * x) },
+		{ 2.0f * (x * z - w * y), 2.0f * (y * z + w * x), 1.0f - 2.0f * (x * x + y * y) }
+	};
+	for (int r = 0; r < 3; r++) {
+		for (int c = 0; c < 3; c++) {
+			matrix.rows[r][c] = rotation[r][c] * local.scale[c];
+		}
+		matrix.rows[r][3] = local.position[r];
+	}
+}
+
+// Helper function to multiply two affine matrices, parent on the left
+static void multiply(const WorldMatrix &parent, const WorldMatrix &local, WorldMatrix &result) {
+	for (int r = 0; r < 3; r++) {
+		const float* p = parent.rows[r];
+		for (int c = 0; c < 4; c++) {
+			result.rows[r][c] = p[0] * local.rows[0][c] + p[1] * local.rows[1][c] + p[2] * local.rows[2][c];
+		}
+		result.rows[r][3] += p[3];
+	}
+}
+
+// Constructor starts with no nodes
+SceneGraph::SceneGraph() : firstDirty(0) {
+}
+
+// Append a node under a parent that already exists, so parents always come before their children.
+// Returns the node's index
+int SceneGraph::addNode(int parent, const NodeTransform &local) {
+	if (parent != NO_PARENT && (parent < 0 || parent >= (int)parents.size())) {
+		std::cout << "Error: scene graph node parent " << parent << " does not exist" << std::endl;
+		parent = NO_PARENT;
+	}
+	parents.push_back(parent);
+	locals.push_back(local);
+	worlds.push_back(WorldMatrix());
+	dirty.push_back(1);
+	firstDirty = std::min(firstDirty, parents.size() - 1);
+	return (int)parents.size() - 1;
+}
+
+// Change a node's local transform, marking it and so everything below it for the next update
+void SceneGraph::setLocal(int node, const NodeTransform &local) {
+	locals[node] = local;
+	dirty[node] = 1;
+	firstDirty = std::min(firstDirty, (size_t)node);
+}
+
+const NodeTransform &SceneGraph::getLocal(int node) const {
+	return locals[node];
+}
+
+// Parent of a node, NO_PARENT for a root
+int SceneGraph::getParent(int node) const {
+	return parents[node];
+}
+
+// Recompute the world matrices of dirty nodes and their descendants in one pass, starting at the first
+// dirty node. Children inherit the flag from their parent on the way, since the parent comes first.
+// Returns the number of matrices recomputed
+size_t SceneGraph::update() {
+	size_t count = parents.size();
+	if (firstDirty >= count) {
+		return 0;
+	}
+	size_t recomputed = 0;
+	WorldMatrix local;
+	for (size_t i = firstDirty; i < count; i++) {
+		int parent = parents[i];
+		if (parent != NO_PARENT) {
+			dirty[i] |= dirty[parent];
+		}
+		if (!dirty[i]) {
+			continue;
+		}
+		if (parent == NO_PARENT) {
+			composeLocal(locals[i], worlds[i]);
+		}
+		else {
+			composeLocal(locals[i], local);
+			multiply(worlds[parent], local, worlds[i]);
+		}
+		recomputed++;
+	}
+	// The flags are only cleared afterwards, children further on still read their parent's
+	std::fill(dirty.begin() + firstDirty, dirty.end(), 0);
+	firstDirty = count;
+	return recomputed;
+}
+
+// Mark every node, so the next update recomputes the whole graph
+void SceneGraph::markAllDirty() {
+	std::fill(dirty.begin(), dirty.end(), 1);
+	firstDirty = 0;
+}
+
+// World matrix of a node as of the last update
+const WorldMatrix &SceneGraph::getWorld(int node) const {
+	return worlds[node];
+}
+
+// Every world matrix in node order, ready to copy into an instance buffer
+const std::vector<WorldMatrix> &SceneGraph::getWorldMatrices() const {
+	return worlds;
+}
+
+// Number of nodes
+size_t SceneGraph::size() const {
+	return parents.size();
+}
+
+// Constructor adds world matrix attributes 7 to 9 to a vertex array that already holds a mesh and its indices
+WorldInstances::WorldInstances(unsigned int vertexArray, size_t capacity, GLenum indexType)
+	: vertexArray(vertexArray), indexType(indexType), stream(new StreamBuffer(capacity * sizeof(WorldMatrix))), capacity(capacity), count(0) {
+	// The attribute pointers are moved on each upload, since every frame writes to a different region
+	setAttributes(0);
+	for (unsigned int attribute = 7; attribute <= 9; attribute++) {
+		glEnableVertexAttribArray(attribute);
+		glVertexAttribDivisor(attribute, 1);
+	}
+}
+
+// Write every world matrix of the graph into this frame's region of the stream buffer, growing it if needed
+void WorldInstances::upload(const SceneGraph &graph) {
+	const std::vector<WorldMatrix> &matrices = graph.getWorldMatrices();
+	if (matrices.size() > capacity) {
+		capacity = matrices.size();
+		stream.reset(new StreamBuffer(capacity * sizeof(WorldMatrix)));
+	}
+	count = 0;
+	if (matrices.empty()) {
+		return;
+	}
+	stream->beginFrame();
+	StreamAllocation allocation = stream->allocate(matrices.size() * sizeof(WorldMatrix), sizeof(float));
+	if (allocation.data == NULL) {
+		return;
+	}
+	std::memcpy(allocation.data, matrices.data(), allocation.size);
+	stream->flush();
+	count = matrices.size();
+	setAttributes(allocation.offset);
+}
+
+// Draw indexCount indices once per uploaded node and fence the region. The shader must be the
+// INSTANCED and WORLD_MATRIX variant and already be in use
+void WorldInstances::draw(GLsizei indexCount) {
+	if (count == 0) {
+		return;
+	}
+	GLState::bindVertexArray(vertexArray);
+	glDrawElementsInstanced(GL_TRIANGLES, indexCount, indexType, 0, (GLsizei)count);
+	stream->endFrame();
+}
+
+// Number of instances uploaded
+size_t WorldInstances::size() const {
+	return count;
+}
+
+// Helper function to point the matrix rows at the data starting at offset in the stream buffer
+void WorldInstances::setAttributes(size_t offset) {
+	GLState::bindVertexArray(vertexArray);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, stream->buffer);
+	const char* base = (const char*)offset;
+	for (unsigned int row = 0; row < 3; row++) {
+		glVertexAttribPointer(7 + row, 4, GL_FLOAT, GL_FALSE, sizeof(WorldMatrix), base + row * 4 * sizeof(float));
+	}
+}
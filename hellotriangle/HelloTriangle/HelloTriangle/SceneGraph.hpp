@@ -0,0 +1,113 @@
+/*
+ * SceneGraph.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Transform hierarchy in flat arrays ordered parent before child, with world matrices updated lazily
+ */
+
+#ifndef SCENEGRAPH_HPP
+#define SCENEGRAPH_HPP
+
+#include <GL/glew.h>
+
+#include <memory>
+#include <vector>
+#include <iostream>
+
+#include "GLState.hpp"
+#include "StreamBuffer.hpp"
+
+// Local transform of a node, applied as scale, then rotation, then translation
+struct NodeTransform {
+	float position[3];
+	float rotation[4];	// unit quaternion x, y, z, w
+	float scale[3];
+
+	// No translation or rotation and a scale of 1
+	static NodeTransform identity();
+
+	// Rotate by angle radians about the z axis, keeping the rest
+	void setRotationZ(float angle);
+};
+
+// Top three rows of an affine 4x4 matrix, row-major. The bottom row is always 0 0 0 1 and is not stored
+struct WorldMatrix {
+	float rows[3][4];
+};
+
+class SceneGraph {
+public:
+	// Parent of a root node
+	static const int NO_PARENT;
+
+	// Constructor starts with no nodes
+	SceneGraph();
+
+	// Append a node under a parent that already exists, so parents always come before their children.
+	// Returns the node's index
+	int addNode(int parent, const NodeTransform &local);
+
+	// Change a node's local transform, marking it and so everything below it for the next update
+	void setLocal(int node, const NodeTransform &local);
+	const NodeTransform &getLocal(int node) const;
+
+	// Parent of a node, NO_PARENT for a root
+	int getParent(int node) const;
+
+	// Recompute the world matrices of dirty nodes and their descendants in one pass, starting at the first
+	// dirty node. Children inherit the flag from their parent on the way, since the parent comes first.
+	// Returns the number of matrices recomputed
+	size_t update();
+
+	// Mark every node, so the next update recomputes the whole graph
+	void markAllDirty();
+
+	// World matrix of a node as of the last update
+	const WorldMatrix &getWorld(int node) const;
+
+	// Every world matrix in node order, ready to copy into an instance buffer
+	const std::vector<WorldMatrix> &getWorldMatrices() const;
+
+	// Number of nodes
+	size_t size() const;
+
+private:
+	std::vector<int> parents;
+	std::vector<NodeTransform> locals;
+	std::vector<WorldMatrix> worlds;
+	std::vector<unsigned char> dirty;
+	size_t firstDirty;
+};
+
+class WorldInstances {
+public:
+	// Constructor adds world matrix attributes 7 to 9 to a vertex array that already holds a mesh and its indices
+	WorldInstances(unsigned int vertexArray, size_t capacity, GLenum indexType = GL_UNSIGNED_INT);
+
+	// Write every world matrix of the graph into this frame's region of the stream buffer, growing it if needed
+	void upload(const SceneGraph &graph);
+
+	// Draw indexCount indices once per uploaded node and fence the region. The shader must be the
+	// INSTANCED and WORLD_MATRIX variant and already be in use
+	void draw(GLsizei indexCount);
+
+	// Number of instances uploaded
+	size_t size() const;
+
+private:
+	// The stream buffer is owned, so it cannot be copied
+	WorldInstances(const WorldInstances &);
+	WorldInstances &operator=(const WorldInstances &);
+
+	unsigned int vertexArray;
+	GLenum indexType;
+	std::unique_ptr<StreamBuffer> stream;
+	size_t capacity;
+	size_t count;
+
+	// Helper function to point the matrix rows at the data starting at offset in the stream buffer
+	void setAttributes(size_t offset);
+};
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ * ShaderCache.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * On-disk cache of linked program binaries
+ */
+
+#include "ShaderCache.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+// Header written in front of each cached binary
+struct ProgramBinaryHeader {
+	char magic[4];
+	unsigned int format;
+	unsigned int length;
+	float buildMilliseconds;
+};
+
+// Constructor creates the cache directory and checks that the driver can save program binaries
+ProgramBinaryCache::ProgramBinaryCache(const std::string &directory)
+	: directory(directory), enabled(false), hits(0), misses(0), rejected(0), millisecondsSaved(0.0) {
+	int formats = 0;
+	if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary) {
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	}
+	enabled = formats > 0;
+	if (!enabled) {
+		std::cout << "Warning: program binaries are not supported, shader cache disabled" << std::endl;
+		return;
+	}
+
+	// Binaries are only valid for the driver that produced them
+	driverIdentity = std::string((const char*)glGetString(GL_VENDOR)) + "\n"
+		+ (const char*)glGetString(GL_RENDERER) + "\n"
+		+ (const char*)glGetString(GL_VERSION);
+
+#ifdef _WIN32
+	_mkdir(directory.c_str());
+#else
+	mkdir(directory.c_str(), 0755);
+#endif
+}
+
+// Build a cache key from the hashes of the stage sources, the defines and the driver identity
+unsigned long long ProgramBinaryCache::makeKey(const std::vector<unsigned long long> &sourceHashes, const std::string &defines) const {
+	unsigned long long key = hashText(driverIdentity);
+	key = hashText(defines, key);
+	for (size_t i = 0; i < sourceHashes.size(); i++) {
+		key = hashBytes((const char*)&sourceHashes[i], sizeof(sourceHashes[i]), key);
+	}
+	return key;
+}
+
+// Try to load the cached binary for the key into the program, true if the driver accepted it
+bool ProgramBinaryCache::load(unsigned int program, unsigned long long key) {
+	if (!enabled) {
+		return false;
+	}
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+	std::ifstream file(pathForKey(key).c_str(), std::ios::binary);
+	ProgramBinaryHeader header;
+	if (!file || !file.read((char*)&header, sizeof(header)) || std::memcmp(header.magic, "GLPB", 4) != 0) {
+		misses++;
+		return false;
+	}
+	// A truncated or corrupt file must not size the buffer, the length has to match what follows the header
+	std::streamoff offset = file.tellg();
+	file.seekg(0, std::ios::end);
+	std::streamoff remaining = file.tellg() - offset;
+	if (!file || header.length == 0 || remaining != (std::streamoff)header.length) {
+		rejected++;
+		return false;
+	}
+	file.seekg(offset);
+	std::vector<char> binary(header.length);
+	if (!file.read(binary.data(), header.length)) {
+		rejected++;
+		return false;
+	}
+
+	// The driver may refuse a binary after an update even when the identity strings match
+	int success = 0;
+	glProgramBinary(program, header.format, binary.data(), (GLsizei)header.length);
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success) {
+		rejected++;
+		return false;
+	}
+
+	double loadMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	hits++;
+	millisecondsSaved += header.buildMilliseconds - loadMilliseconds;
+	return true;
+}
+
+// Save the binary of a freshly linked program along with the time it took to build
+void ProgramBinaryCache::store(unsigned int program, unsigned long long key, double buildMilliseconds) {
+	int success = 0, length = 0;
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!enabled || !success) {
+		return;
+	}
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0) {
+		return;
+	}
+
+	ProgramBinaryHeader header;
+	std::memcpy(header.magic, "GLPB", 4);
+	header.buildMilliseconds = (float)buildMilliseconds;
+	std::vector<char> binary(length);
+	GLenum format = 0;
+	glGetProgramBinary(program, length, NULL, &format, binary.data());
+	header.format = format;
+	header.length = (unsigned int)length;
+
+	std::ofstream file(pathForKey(key).c_str(), std::ios::binary | std::ios::trunc);
+	if (!file) {
+		std::cout << "Error: could not write shader cache file " << pathForKey(key) << std::endl;
+		return;
+	}
+	file.write((const char*)&header, sizeof(header));
+	file.write(binary.data(), length);
+}
+
+// True if the driver supports program binaries with at least one format
+bool ProgramBinaryCache::isEnabled() const {
+	return enabled;
+}
+
+// Print the number of hits, misses and rejected binaries, and the build time saved
+void ProgramBinaryCache::printReport() const {
+	std::cout << "Shader cache: " << hits << " hits, " << misses << " misses, " << rejected
+		<< " rejected, " << millisecondsSaved << " ms saved" << std::endl;
+}
+
+// 64-bit FNV-1a hash of a block of text, chained through the seed
+unsigned long long ProgramBinaryCache::hashText(const std::string &text, unsigned long long seed) {
+	return hashBytes(text.data(), text.size(), seed);
+}
+
+unsigned long long ProgramBinaryCache::hashBytes(const char* data, size_t length, unsigned long long seed) {
+	unsigned long long hash = seed;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= (unsigned char)data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+// Helper function to build the path of the cache file for a key
+std::string ProgramBinaryCache::pathForKey(unsigned long long key) const {
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.bin", key);
+	return directory + "/" + name;
+}
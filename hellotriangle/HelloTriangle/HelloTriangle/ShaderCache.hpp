@@ -0,0 +1,56 @@
+/*
+ * ShaderCache.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * On-disk cache of linked program binaries
+ */
+
+#ifndef SHADERCACHE_HPP
+#define SHADERCACHE_HPP
+
+#include <GL/glew.h>
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+class ProgramBinaryCache {
+public:
+	// Constructor creates the cache directory and checks that the driver can save program binaries
+	ProgramBinaryCache(const std::string &directory);
+
+	// Build a cache key from the hashes of the stage sources, the defines and the driver identity
+	unsigned long long makeKey(const std::vector<unsigned long long> &sourceHashes, const std::string &defines) const;
+
+	// Try to load the cached binary for the key into the program, true if the driver accepted it
+	bool load(unsigned int program, unsigned long long key);
+
+	// Save the binary of a freshly linked program along with the time it took to build
+	void store(unsigned int program, unsigned long long key, double buildMilliseconds);
+
+	// True if the driver supports program binaries with at least one format
+	bool isEnabled() const;
+
+	// Print the number of hits, misses and rejected binaries, and the build time saved
+	void printReport() const;
+
+	// 64-bit FNV-1a hash of a block of text, chained through the seed
+	static unsigned long long hashText(const std::string &text, unsigned long long seed = 14695981039346656037ull);
+	static unsigned long long hashBytes(const char* data, size_t length, unsigned long long seed = 14695981039346656037ull);
+
+private:
+	std::string directory;
+	std::string driverIdentity;
+	bool enabled;
+
+	int hits;
+	int misses;
+	int rejected;
+	double millisecondsSaved;
+
+	// Helper function to build the path of the cache file for a key
+	std::string pathForKey(unsigned long long key) const;
+};
+
+#endif
@@ -0,0 +1,210 @@
+/*
+ * ShaderPipeline.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Separable single-stage programs combined at draw time through program pipeline objects
+ */
+
+#include "ShaderPipeline.hpp"
+
+#include <vector>
+#include <chrono>
+
+unsigned int ShaderStage::linkCount = 0;
+unsigned int ShaderStage::nextSerial = 1;
+
+// True if the context supports GL_ARB_separate_shader_objects or GL 4.1
+bool ShaderStage::isSupported() {
+	return GLEW_ARB_separate_shader_objects || GLEW_VERSION_4_1;
+}
+
+// Constructor preprocesses and links the stage, type is GL_VERTEX_SHADER or GL_FRAGMENT_SHADER
+ShaderStage::ShaderStage(GLenum type, const char* path, const ShaderDefines &defines, ProgramBinaryCache* cache)
+	: ID(0), serial(nextSerial++), type(type), path(path), failed(false) {
+	// Shaders use this to redeclare gl_PerVertex and enable the extension only when built as a stage
+	ShaderDefines stageDefines = defines;
+	stageDefines.set("SEPARABLE_STAGE");
+
+	ID = glCreateProgram();
+	glProgramParameteri(ID, GL_PROGRAM_SEPARABLE, GL_TRUE);
+	ShaderSource source;
+	if (!preprocessShader(path, stageDefines, source)) {
+		std::cout << "Error: could not load the source for stage " << path << std::endl;
+		failed = true;
+		return;
+	}
+
+	/* ----- Load a previously linked binary if the source is unchanged ----- */
+
+	unsigned long long cacheKey = 0;
+	if (cache != NULL && cache->isEnabled()) {
+		std::vector<unsigned long long> sources(1, source.hash());
+		cacheKey = cache->makeKey(sources, stageDefines.toString());
+		if (cache->load(ID, cacheKey)) {
+			return;
+		}
+		// A rejected binary can leave the program in a failed state, so start from a fresh one
+		glDeleteProgram(ID);
+		ID = glCreateProgram();
+		glProgramParameteri(ID, GL_PROGRAM_SEPARABLE, GL_TRUE);
+		glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+	/* ----- Compile and link the single stage ----- */
+
+	int success;
+	char infoLog[1024];
+	unsigned int shader = glCreateShader(type);
+	glShaderSource(shader, source.count(), source.strings(), source.lengths());
+	glCompileShader(shader);
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+	if (!success) {
+		glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+		std::cout << "Error: Shader compilation error in " << path << "\n" << infoLog << std::endl;
+		failed = true;
+	}
+	glAttachShader(ID, shader);
+	glLinkProgram(ID);
+	linkCount++;
+	glGetProgramiv(ID, GL_LINK_STATUS, &success);
+	if (!success) {
+		glGetProgramInfoLog(ID, 1024, NULL, infoLog);
+		std::cout << "Error: program linking error in " << path << "\n" << infoLog << std::endl;
+		failed = true;
+	}
+	glDetachShader(ID, shader);
+	glDeleteShader(shader);
+
+	if (cache != NULL && !failed) {
+		cache->store(ID, cacheKey, std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
+	}
+}
+
+// Destructor deletes the program
+ShaderStage::~ShaderStage() {
+	glDeleteProgram(ID);
+}
+
+// True if the source could not be loaded or did not compile and link
+bool ShaderStage::hasFailed() const {
+	return failed;
+}
+
+// Stage type and the matching bit for glUseProgramStages
+GLenum ShaderStage::getType() const {
+	return type;
+}
+
+GLbitfield ShaderStage::getStageBit() const {
+	switch (type) {
+	case GL_VERTEX_SHADER:   return GL_VERTEX_SHADER_BIT;
+	case GL_FRAGMENT_SHADER: return GL_FRAGMENT_SHADER_BIT;
+	case GL_GEOMETRY_SHADER: return GL_GEOMETRY_SHADER_BIT;
+	default:                 return 0;
+	}
+}
+
+// Source path the stage was built from
+const std::string &ShaderStage::getPath() const {
+	return path;
+}
+
+// Number never given to another stage, unlike the program name which GL reuses once a stage is deleted
+unsigned int ShaderStage::getSerial() const {
+	return serial;
+}
+
+// Set uniforms directly on the stage program with glProgramUniform, no bind needed
+void ShaderStage::setBool(const std::string &name, bool value) {
+	glProgramUniform1i(ID, getUniformLocation(name), (int)value);
+}
+
+void ShaderStage::setInt(const std::string &name, int value) {
+	glProgramUniform1i(ID, getUniformLocation(name), value);
+}
+
+void ShaderStage::setFloat(const std::string &name, float value) {
+	glProgramUniform1f(ID, getUniformLocation(name), value);
+}
+
+// Number of stage links done by every ShaderStage, binaries loaded from the cache do not count
+unsigned int ShaderStage::getLinkCount() {
+	return linkCount;
+}
+
+// Helper function to look up a uniform location once
+int ShaderStage::getUniformLocation(const std::string &name) {
+	std::unordered_map<std::string, int>::iterator it = locations.find(name);
+	if (it != locations.end()) {
+		return it->second;
+	}
+	int location = glGetUniformLocation(ID, name.c_str());
+	locations[name] = location;
+	return location;
+}
+
+// Constructor starts with no pipelines
+PipelineCache::PipelineCache() : binds(0) {
+}
+
+// Destructor deletes every pipeline object
+PipelineCache::~PipelineCache() {
+	clear();
+}
+
+// Make the pair current for drawing, false if either stage failed or the pipeline does not validate
+bool PipelineCache::bind(const ShaderStage &vertex, const ShaderStage &fragment) {
+	if (vertex.hasFailed() || fragment.hasFailed()) {
+		return false;
+	}
+	binds++;
+	unsigned long long key = ((unsigned long long)vertex.getSerial() << 32) | fragment.getSerial();
+	std::unordered_map<unsigned long long, Pipeline>::iterator it = pipelines.find(key);
+	if (it == pipelines.end()) {
+		Pipeline pipeline;
+		glGenProgramPipelines(1, &pipeline.ID);
+		glUseProgramStages(pipeline.ID, vertex.getStageBit(), vertex.ID);
+		glUseProgramStages(pipeline.ID, fragment.getStageBit(), fragment.ID);
+
+		// Validation catches interface mismatches between the stages, checked once rather than every draw
+		int valid = 0;
+		glValidateProgramPipeline(pipeline.ID);
+		glGetProgramPipelineiv(pipeline.ID, GL_VALIDATE_STATUS, &valid);
+		pipeline.valid = valid != 0;
+		if (!pipeline.valid) {
+			char infoLog[1024];
+			glGetProgramPipelineInfoLog(pipeline.ID, 1024, NULL, infoLog);
+			std::cout << "Error: pipeline " << vertex.getPath() << " + " << fragment.getPath()
+				<< " did not validate\n" << infoLog << std::endl;
+		}
+		it = pipelines.insert(std::make_pair(key, pipeline)).first;
+	}
+	if (!it->second.valid) {
+		return false;
+	}
+	// A current program overrides the bound pipeline, so it has to be cleared first
+	GLState::useProgram(0);
+	GLState::bindProgramPipeline(it->second.ID);
+	return true;
+}
+
+// Delete every pipeline object, needed before the context is destroyed
+void PipelineCache::clear() {
+	for (std::unordered_map<unsigned long long, Pipeline>::iterator it = pipelines.begin(); it != pipelines.end(); ++it) {
+		GLState::deleteProgramPipeline(it->second.ID);
+	}
+	pipelines.clear();
+}
+
+// Number of pipeline objects created
+size_t PipelineCache::size() const {
+	return pipelines.size();
+}
+
+// Print how many links and pipelines the stages needed for the combinations drawn
+void PipelineCache::printReport() const {
+	std::cout << "Program pipelines: " << ShaderStage::getLinkCount() << " stage links, "
+		<< pipelines.size() << " pipelines, " << binds << " binds" << std::endl;
+}
@@ -0,0 +1,110 @@
+/*
+ * ShaderPipeline.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Separable single-stage programs combined at draw time through program pipeline objects
+ */
+
+#ifndef SHADERPIPELINE_HPP
+#define SHADERPIPELINE_HPP
+
+#include <GL/glew.h>
+
+#include <string>
+#include <unordered_map>
+#include <iostream>
+
+#include "ShaderCache.hpp"
+#include "ShaderPreprocessor.hpp"
+#include "GLState.hpp"
+
+// One shader stage linked on its own as a separable program, so it can be paired with any other stage
+class ShaderStage {
+public:
+	unsigned int ID;
+
+	// True if the context supports GL_ARB_separate_shader_objects or GL 4.1
+	static bool isSupported();
+
+	// Constructor preprocesses and links the stage, type is GL_VERTEX_SHADER or GL_FRAGMENT_SHADER
+	ShaderStage(GLenum type, const char* path, const ShaderDefines &defines = ShaderDefines(), ProgramBinaryCache* cache = NULL);
+
+	// Destructor deletes the program
+	~ShaderStage();
+
+	// True if the source could not be loaded or did not compile and link
+	bool hasFailed() const;
+
+	// Stage type and the matching bit for glUseProgramStages
+	GLenum getType() const;
+	GLbitfield getStageBit() const;
+
+	// Source path the stage was built from
+	const std::string &getPath() const;
+
+	// Number never given to another stage, unlike the program name which GL reuses once a stage is deleted
+	unsigned int getSerial() const;
+
+	// Set uniforms directly on the stage program with glProgramUniform, no bind needed
+	void setBool(const std::string &name, bool value);
+	void setInt(const std::string &name, int value);
+	void setFloat(const std::string &name, float value);
+
+	// Number of stage links done by every ShaderStage, binaries loaded from the cache do not count
+	static unsigned int getLinkCount();
+
+private:
+	// A stage owns its program object, so it cannot be copied
+	ShaderStage(const ShaderStage &);
+	ShaderStage &operator=(const ShaderStage &);
+
+	static unsigned int linkCount;
+	static unsigned int nextSerial;
+
+	unsigned int serial;
+	GLenum type;
+	std::string path;
+	bool failed;
+
+	// Uniform locations looked up so far
+	std::unordered_map<std::string, int> locations;
+
+	// Helper function to look up a uniform location once
+	int getUniformLocation(const std::string &name);
+};
+
+// Pipeline objects for each vertex/fragment pair that has been drawn with, created on first use
+class PipelineCache {
+public:
+	// Constructor starts with no pipelines
+	PipelineCache();
+
+	// Destructor deletes every pipeline object
+	~PipelineCache();
+
+	// Make the pair current for drawing, false if either stage failed or the pipeline does not validate
+	bool bind(const ShaderStage &vertex, const ShaderStage &fragment);
+
+	// Delete every pipeline object, needed before the context is destroyed
+	void clear();
+
+	// Number of pipeline objects created
+	size_t size() const;
+
+	// Print how many links and pipelines the stages needed for the combinations drawn
+	void printReport() const;
+
+private:
+	// Pipeline object and whether it passed validation when it was created
+	struct Pipeline {
+		unsigned int ID;
+		bool valid;
+	};
+
+	// Keyed by both stage serials, so a pipeline is never reused for a new stage that got a deleted one's name
+	std::unordered_map<unsigned long long, Pipeline> pipelines;
+	unsigned int binds;
+};
+
+#endif
@@ -0,0 +1,189 @@
+/*
+ * ShaderPreprocessor.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * GLSL #include expansion and injected #define sets
+ */
+
+#include "ShaderPreprocessor.hpp"
+
+#include <atomic>
+#include <thread>
+#include <cstring>
+#include <algorithm>
+
+// Deep enough for any sensible include tree, shallow enough to stop a cycle quickly
+static const int maxIncludeDepth = 16;
+
+// Add or replace a define
+ShaderDefines &ShaderDefines::set(const std::string &name, const std::string &value) {
+	std::vector<std::pair<std::string, std::string> >::iterator it = defines.begin();
+	while (it != defines.end() && it->first < name) {
+		++it;
+	}
+	if (it != defines.end() && it->first == name) {
+		it->second = value;
+	}
+	else {
+		defines.insert(it, std::make_pair(name, value));
+	}
+	return *this;
+}
+
+ShaderDefines &ShaderDefines::set(const std::string &name, int value) {
+	return set(name, std::to_string(value));
+}
+
+// Canonical "#define NAME VALUE" lines, also used as the variant and cache key
+std::string ShaderDefines::toString() const {
+	std::string text;
+	for (size_t i = 0; i < defines.size(); i++) {
+		text += "#define " + defines[i].first + " " + defines[i].second + "\n";
+	}
+	return text;
+}
+
+// Helper function to check whether text at a position starts with a directive name
+static bool startsWith(const char* text, size_t available, const char* directive) {
+	size_t length = std::strlen(directive);
+	return available >= length && std::memcmp(text, directive, length) == 0;
+}
+
+// Helper function to find the start of the #version line, which GLSL only allows before anything but comments and
+// whitespace. Returns size when the first directive is something else
+static size_t findVersionLine(const char* text, size_t size) {
+	size_t i = 0;
+	while (i < size) {
+		if (text[i] == ' ' || text[i] == '\t' || text[i] == '\r' || text[i] == '\n') {
+			i++;
+		}
+		else if (startsWith(text + i, size - i, "//")) {
+			const char* newline = (const char*)std::memchr(text + i, '\n', size - i);
+			i = newline == NULL ? size : (size_t)(newline - text) + 1;
+		}
+		else if (startsWith(text + i, size - i, "/*")) {
+			const char* end = std::search(text + i + 2, text + size, "*/", "*/" + 2);
+			i = end == text + size ? size : (size_t)(end - text) + 2;
+		}
+		else {
+			break;
+		}
+	}
+	if (i == size || !startsWith(text + i, size - i, "#version")) {
+		return size;
+	}
+	// Back up to the start of the line so the caller can match it
+	while (i > 0 && text[i - 1] != '\n') {
+		i--;
+	}
+	return i;
+}
+
+// Helper function to add a file to the output with its includes expanded in place, injecting defines after #version
+static bool expandIncludes(const std::string &path, const ShaderDefines* defines, ShaderSource &output, int depth) {
+	if (depth > maxIncludeDepth) {
+		std::cout << "Error: includes nested too deeply at " << path << std::endl;
+		return false;
+	}
+	// Each file is pasted once, so shared headers need no include guards
+	const std::vector<std::string> &paths = output.getPaths();
+	if (std::find(paths.begin(), paths.end(), path) != paths.end()) {
+		return true;
+	}
+	output.addPath(path);
+
+	std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+	std::string error;
+	if (!file->open(path, error)) {
+		std::cout << "Error: shader file " << error << std::endl;
+		return false;
+	}
+	const char* text = file->data();
+	size_t size = file->size();
+	size_t slash = path.find_last_of("/\\");
+	std::string directory = slash == std::string::npos ? "" : path.substr(0, slash + 1);
+
+	// Without a #version line the defines simply go first
+	std::string injected = defines != NULL ? defines->toString() : "";
+	size_t versionLine = injected.empty() ? size : findVersionLine(text, size);
+	if (!injected.empty() && versionLine == size) {
+		output.appendText(injected + "#line 1\n");
+	}
+
+	// Unchanged lines are passed on as ranges of the mapped file
+	size_t runStart = 0;
+	int lineNumber = 0;
+	for (size_t lineStart = 0; lineStart < size; ) {
+		const char* newline = (const char*)std::memchr(text + lineStart, '\n', size - lineStart);
+		size_t lineEnd = newline == NULL ? size : (size_t)(newline - text) + 1;
+		size_t first = lineStart;
+		while (first < lineEnd && (text[first] == ' ' || text[first] == '\t')) {
+			first++;
+		}
+		lineNumber++;
+
+		if (lineStart == versionLine) {
+			// Defines have to follow the #version line, which must come first
+			output.appendFile(file, runStart, lineEnd - runStart);
+			if (!output.endsWithNewline()) {
+				output.appendText("\n");
+			}
+			output.appendText(injected + "#line " + std::to_string(lineNumber + 1) + "\n");
+			runStart = lineEnd;
+		}
+		else if (startsWith(text + first, lineEnd - first, "#include")) {
+			const char* open = (const char*)std::memchr(text + first, '"', lineEnd - first);
+			const char* close = open == NULL ? NULL : (const char*)std::memchr(open + 1, '"', text + lineEnd - open - 1);
+			if (close == NULL) {
+				std::cout << "Error: malformed #include at " << path << ":" << lineNumber << std::endl;
+				return false;
+			}
+			output.appendFile(file, runStart, lineStart - runStart);
+			// Included paths are relative to the including file
+			output.appendText("#line 1\n");
+			if (!expandIncludes(directory + std::string(open + 1, close), NULL, output, depth + 1)) {
+				return false;
+			}
+			if (!output.endsWithNewline()) {
+				output.appendText("\n");
+			}
+			// Keep compiler messages pointing at the right line of this file
+			output.appendText("#line " + std::to_string(lineNumber + 1) + "\n");
+			runStart = lineEnd;
+		}
+		lineStart = lineEnd;
+	}
+	output.appendFile(file, runStart, size - runStart);
+	return true;
+}
+
+// Expand the #include "file" directives of a shader and inject the defines, without copying file contents
+bool preprocessShader(const std::string &path, const ShaderDefines &defines, ShaderSource &output) {
+	output = ShaderSource();
+	return expandIncludes(path, &defines, output, 0);
+}
+
+// Preprocess many stages on worker threads, false if any of them failed
+bool preprocessShaderBatch(const std::vector<ShaderSourceRequest> &requests, std::vector<ShaderSource> &outputs) {
+	outputs.assign(requests.size(), ShaderSource());
+	std::atomic<size_t> next(0);
+	std::atomic<bool> success(true);
+
+	// Each worker takes the next unclaimed request until there are none left
+	unsigned int workerCount = std::max(1u, std::min(std::thread::hardware_concurrency(), (unsigned int)requests.size()));
+	std::vector<std::thread> workers;
+	for (unsigned int w = 0; w < workerCount; w++) {
+		workers.push_back(std::thread([&]() {
+			for (size_t i = next++; i < requests.size(); i = next++) {
+				if (!preprocessShader(requests[i].path, requests[i].defines, outputs[i])) {
+					success = false;
+				}
+			}
+		}));
+	}
+	for (size_t w = 0; w < workers.size(); w++) {
+		workers[w].join();
+	}
+	return success;
+}
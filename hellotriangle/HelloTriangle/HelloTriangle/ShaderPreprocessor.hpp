@@ -0,0 +1,45 @@
+/*
+ * ShaderPreprocessor.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * GLSL #include expansion and injected #define sets
+ */
+
+#ifndef SHADERPREPROCESSOR_HPP
+#define SHADERPREPROCESSOR_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <iostream>
+
+#include "ShaderSource.hpp"
+
+// Set of #define lines injected after a shader's #version line, kept sorted so equal sets compare equal
+class ShaderDefines {
+public:
+	// Add or replace a define
+	ShaderDefines &set(const std::string &name, const std::string &value = "1");
+	ShaderDefines &set(const std::string &name, int value);
+
+	// Canonical "#define NAME VALUE" lines, also used as the variant and cache key
+	std::string toString() const;
+
+private:
+	std::vector<std::pair<std::string, std::string> > defines;
+};
+
+// Expand the #include "file" directives of a shader and inject the defines, without copying file contents
+bool preprocessShader(const std::string &path, const ShaderDefines &defines, ShaderSource &output);
+
+// One stage to preprocess as part of a batch
+struct ShaderSourceRequest {
+	std::string path;
+	ShaderDefines defines;
+};
+
+// Preprocess many stages on worker threads, false if any of them failed
+bool preprocessShaderBatch(const std::vector<ShaderSourceRequest> &requests, std::vector<ShaderSource> &outputs);
+
+#endif
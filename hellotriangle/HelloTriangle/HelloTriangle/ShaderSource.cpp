@@ -0,0 +1,187 @@
+/*
+ * ShaderSource.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Memory-mapped shader files and stage sources handed to glShaderSource without copying
+ */
+
+#include "ShaderSource.hpp"
+#include "ShaderCache.hpp"
+
+#include <cerrno>
+#include <cstring>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+MappedFile::MappedFile() : mapping(NULL), length(0) {
+#ifdef _WIN32
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = NULL;
+#endif
+}
+
+// Destructor unmaps the file
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+	if (mapping != NULL) {
+		UnmapViewOfFile(mapping);
+	}
+	if (mappingHandle != NULL) {
+		CloseHandle(mappingHandle);
+	}
+	if (fileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(fileHandle);
+	}
+#else
+	if (mapping != NULL) {
+		munmap((void*)mapping, length);
+	}
+#endif
+}
+
+// Map a whole file read-only, false with a description in error if it is missing or empty
+bool MappedFile::open(const std::string &path, std::string &error) {
+#ifdef _WIN32
+	fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		error = "cannot open " + path;
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0) {
+		error = path + " is empty";
+		return false;
+	}
+	length = (size_t)fileSize.QuadPart;
+	mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mappingHandle == NULL) {
+		error = "cannot map " + path;
+		return false;
+	}
+	mapping = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (mapping == NULL) {
+		error = "cannot map " + path;
+		return false;
+	}
+#else
+	int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd == -1) {
+		error = "cannot open " + path + ": " + std::strerror(errno);
+		return false;
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0) {
+		error = "cannot stat " + path + ": " + std::strerror(errno);
+		close(fd);
+		return false;
+	}
+	if (info.st_size == 0) {
+		error = path + " is empty";
+		close(fd);
+		return false;
+	}
+	length = (size_t)info.st_size;
+	void* address = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	// The mapping keeps the file contents alive, so the descriptor is not needed any more
+	close(fd);
+	if (address == MAP_FAILED) {
+		error = "cannot map " + path + ": " + std::strerror(errno);
+		return false;
+	}
+	mapping = (const char*)address;
+#endif
+	return true;
+}
+
+const char* MappedFile::data() const {
+	return mapping;
+}
+
+size_t MappedFile::size() const {
+	return length;
+}
+
+// Add a range of a mapped file, which stays mapped for as long as the source exists
+void ShaderSource::appendFile(const std::shared_ptr<MappedFile> &file, size_t offset, size_t length) {
+	if (length == 0) {
+		return;
+	}
+	if (files.empty() || files.back() != file) {
+		files.push_back(file);
+	}
+	segmentData.push_back(file->data() + offset);
+	segmentLengths.push_back((GLint)length);
+}
+
+// Add generated text such as injected defines or #line directives
+void ShaderSource::appendText(const std::string &text) {
+	if (text.empty()) {
+		return;
+	}
+	texts.push_back(std::make_shared<std::string>(text));
+	segmentData.push_back(texts.back()->data());
+	segmentLengths.push_back((GLint)text.size());
+}
+
+// Record a file that was read to build this source
+void ShaderSource::addPath(const std::string &path) {
+	paths.push_back(path);
+}
+
+// Copy the segments into owned text and release the mappings, for sources kept after the files are read.
+// A file truncated in place by an editor faults on access while it is still mapped
+void ShaderSource::copyFiles() {
+	if (files.empty()) {
+		return;
+	}
+	std::string text;
+	for (size_t i = 0; i < segmentData.size(); i++) {
+		text.append(segmentData[i], segmentLengths[i]);
+	}
+	files.clear();
+	texts.clear();
+	segmentData.clear();
+	segmentLengths.clear();
+	appendText(text);
+}
+
+// Arrays for glShaderSource, one pointer and length per segment
+GLsizei ShaderSource::count() const {
+	return (GLsizei)segmentData.size();
+}
+
+const char* const* ShaderSource::strings() const {
+	return segmentData.data();
+}
+
+const GLint* ShaderSource::lengths() const {
+	return segmentLengths.data();
+}
+
+// True if the last segment ends a line, so directives can safely follow
+bool ShaderSource::endsWithNewline() const {
+	return segmentData.empty() || segmentData.back()[segmentLengths.back() - 1] == '\n';
+}
+
+// Hash of the full text, computed over the segments without joining them
+unsigned long long ShaderSource::hash(unsigned long long seed) const {
+	for (size_t i = 0; i < segmentData.size(); i++) {
+		seed = ProgramBinaryCache::hashBytes(segmentData[i], segmentLengths[i], seed);
+	}
+	return seed;
+}
+
+// Every file read to build this source, including #include files
+const std::vector<std::string> &ShaderSource::getPaths() const {
+	return paths;
+}
@@ -0,0 +1,84 @@
+/*
+ * ShaderSource.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Memory-mapped shader files and stage sources handed to glShaderSource without copying
+ */
+
+#ifndef SHADERSOURCE_HPP
+#define SHADERSOURCE_HPP
+
+#include <GL/glew.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class MappedFile {
+public:
+	MappedFile();
+
+	// Destructor unmaps the file
+	~MappedFile();
+
+	// Map a whole file read-only, false with a description in error if it is missing or empty
+	bool open(const std::string &path, std::string &error);
+
+	const char* data() const;
+	size_t size() const;
+
+private:
+	const char* mapping;
+	size_t length;
+#ifdef _WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#endif
+
+	// Mappings are owned by exactly one object
+	MappedFile(const MappedFile &);
+	MappedFile &operator=(const MappedFile &);
+};
+
+// Stage source as a list of segments, most pointing straight into mapped files
+class ShaderSource {
+public:
+	// Add a range of a mapped file, which stays mapped for as long as the source exists
+	void appendFile(const std::shared_ptr<MappedFile> &file, size_t offset, size_t length);
+
+	// Add generated text such as injected defines or #line directives
+	void appendText(const std::string &text);
+
+	// Record a file that was read to build this source
+	void addPath(const std::string &path);
+
+	// Copy the segments into owned text and release the mappings, for sources kept after the files are read.
+	// A file truncated in place by an editor faults on access while it is still mapped
+	void copyFiles();
+
+	// Arrays for glShaderSource, one pointer and length per segment
+	GLsizei count() const;
+	const char* const* strings() const;
+	const GLint* lengths() const;
+
+	// True if the last segment ends a line, so directives can safely follow
+	bool endsWithNewline() const;
+
+	// Hash of the full text, computed over the segments without joining them
+	unsigned long long hash(unsigned long long seed = 14695981039346656037ull) const;
+
+	// Every file read to build this source, including #include files
+	const std::vector<std::string> &getPaths() const;
+
+private:
+	// Owners of the memory the segments point into
+	std::vector<std::shared_ptr<MappedFile> > files;
+	std::vector<std::shared_ptr<std::string> > texts;
+
+	std::vector<const char*> segmentData;
+	std::vector<GLint> segmentLengths;
+	std::vector<std::string> paths;
+};
+
+#endif
@@ -0,0 +1,183 @@
+/*
+ * ShaderTimings.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Per-stage and per-program build timings, with a text report and a JSON dump
+ */
+
+#include "ShaderTimings.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+std::vector<ProgramTiming> ShaderBuildLog::records;
+
+// Constructor zeroes every field
+ProgramTiming::ProgramTiming()
+	: cacheKey(0), cacheHit(false), reload(false), cacheLoadMilliseconds(0.0), linkMilliseconds(0.0),
+	statusMilliseconds(0.0), totalMilliseconds(0.0), infoLogLength(0), success(false) {
+	StageTiming empty = { 0, 0.0, 0.0, 0, false };
+	vertex = empty;
+	fragment = empty;
+}
+
+// Helper function to turn the define block into a single line such as "TEXTURE_MIX=0 SHADOWS=1"
+static std::string compactDefines(const std::string &defines) {
+	std::string compact;
+	size_t start = 0;
+	while (start < defines.size()) {
+		size_t end = defines.find('\n', start);
+		if (end == std::string::npos) {
+			end = defines.size();
+		}
+		std::string line = defines.substr(start, end - start);
+		if (line.compare(0, 8, "#define ") == 0) {
+			line = line.substr(8);
+			size_t space = line.find(' ');
+			if (space != std::string::npos) {
+				line[space] = '=';
+			}
+			compact += (compact.empty() ? "" : " ") + line;
+		}
+		start = end + 1;
+	}
+	return compact;
+}
+
+// Helper function to escape a string for a JSON document
+static std::string jsonString(const std::string &text) {
+	std::string escaped = "\"";
+	for (size_t i = 0; i < text.size(); i++) {
+		char c = text[i];
+		if (c == '"' || c == '\\') {
+			escaped += '\\';
+			escaped += c;
+		}
+		else if (c == '\n') {
+			escaped += "\\n";
+		}
+		else if ((unsigned char)c < 0x20) {
+			char code[8];
+			std::snprintf(code, sizeof(code), "\\u%04x", c);
+			escaped += code;
+		}
+		else {
+			escaped += c;
+		}
+	}
+	return escaped + "\"";
+}
+
+// Helper function to print a hash the same way the cache names its files
+static std::string hexHash(unsigned long long hash) {
+	char text[20];
+	std::snprintf(text, sizeof(text), "%016llx", hash);
+	return text;
+}
+
+// Helper function to write the timing of one stage as a JSON object
+static void writeStageJson(std::ofstream &file, const StageTiming &stage) {
+	file << "{ \"sourceHash\": \"" << hexHash(stage.sourceHash) << "\""
+		<< ", \"compileMs\": " << stage.compileMilliseconds
+		<< ", \"statusMs\": " << stage.statusMilliseconds
+		<< ", \"infoLogLength\": " << stage.infoLogLength
+		<< ", \"success\": " << (stage.success ? "true" : "false") << " }";
+}
+
+// Helper function to order builds slowest first
+static bool slowerBuild(const ProgramTiming &a, const ProgramTiming &b) {
+	return a.totalMilliseconds > b.totalMilliseconds;
+}
+
+// Add a finished build
+void ShaderBuildLog::record(const ProgramTiming &timing) {
+	records.push_back(timing);
+}
+
+// All builds in the order they finished
+const std::vector<ProgramTiming> &ShaderBuildLog::getRecords() {
+	return records;
+}
+
+// Print every build, slowest first, with the totals
+void ShaderBuildLog::printReport() {
+	std::vector<ProgramTiming> sorted = records;
+	std::stable_sort(sorted.begin(), sorted.end(), slowerBuild);
+	double total = 0.0;
+	int hits = 0;
+	for (size_t i = 0; i < sorted.size(); i++) {
+		total += sorted[i].totalMilliseconds;
+		hits += sorted[i].cacheHit ? 1 : 0;
+	}
+	std::cout << "Shader builds: " << sorted.size() << " programs, " << hits << " from cache, "
+		<< total << " ms total" << std::endl;
+
+	for (size_t i = 0; i < sorted.size(); i++) {
+		const ProgramTiming &timing = sorted[i];
+		std::string defines = compactDefines(timing.defines);
+		std::cout << "  " << timing.totalMilliseconds << " ms " << timing.vertexPath << " + " << timing.fragmentPath;
+		if (!defines.empty()) {
+			std::cout << " [" << defines << "]";
+		}
+		if (timing.reload) {
+			std::cout << " (reload)";
+		}
+		if (timing.cacheHit) {
+			std::cout << ": cache load " << timing.cacheLoadMilliseconds << " ms";
+		}
+		else {
+			std::cout << ": compile " << timing.vertex.compileMilliseconds << " + " << timing.fragment.compileMilliseconds
+				<< " ms, link " << timing.linkMilliseconds << " ms, status "
+				<< timing.vertex.statusMilliseconds + timing.fragment.statusMilliseconds + timing.statusMilliseconds << " ms";
+		}
+		int logLength = timing.vertex.infoLogLength + timing.fragment.infoLogLength + timing.infoLogLength;
+		if (logLength > 0) {
+			std::cout << ", " << logLength << " bytes of info log";
+		}
+		if (!timing.success) {
+			std::cout << ", FAILED";
+		}
+		std::cout << std::endl;
+	}
+}
+
+// Write every build to a JSON file, false if the file could not be written
+bool ShaderBuildLog::writeJson(const std::string &path) {
+	std::ofstream file(path.c_str(), std::ios::trunc);
+	if (!file) {
+		std::cout << "Error: could not write shader timings to " << path << std::endl;
+		return false;
+	}
+	file << "{\n  \"builds\": [";
+	for (size_t i = 0; i < records.size(); i++) {
+		const ProgramTiming &timing = records[i];
+		file << (i == 0 ? "\n" : ",\n") << "    {\n"
+			<< "      \"vertexPath\": " << jsonString(timing.vertexPath) << ",\n"
+			<< "      \"fragmentPath\": " << jsonString(timing.fragmentPath) << ",\n"
+			<< "      \"defines\": " << jsonString(compactDefines(timing.defines)) << ",\n"
+			<< "      \"cacheKey\": \"" << hexHash(timing.cacheKey) << "\",\n"
+			<< "      \"cacheHit\": " << (timing.cacheHit ? "true" : "false") << ",\n"
+			<< "      \"reload\": " << (timing.reload ? "true" : "false") << ",\n"
+			<< "      \"vertex\": ";
+		writeStageJson(file, timing.vertex);
+		file << ",\n      \"fragment\": ";
+		writeStageJson(file, timing.fragment);
+		file << ",\n"
+			<< "      \"cacheLoadMs\": " << timing.cacheLoadMilliseconds << ",\n"
+			<< "      \"linkMs\": " << timing.linkMilliseconds << ",\n"
+			<< "      \"statusMs\": " << timing.statusMilliseconds << ",\n"
+			<< "      \"totalMs\": " << timing.totalMilliseconds << ",\n"
+			<< "      \"infoLogLength\": " << timing.infoLogLength << ",\n"
+			<< "      \"success\": " << (timing.success ? "true" : "false") << "\n"
+			<< "    }";
+	}
+	file << "\n  ]\n}\n";
+	return file.good();
+}
+
+// Forget all builds
+void ShaderBuildLog::clear() {
+	records.clear();
+}
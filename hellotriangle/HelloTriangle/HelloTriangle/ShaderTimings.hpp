@@ -0,0 +1,70 @@
+/*
+ * ShaderTimings.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Per-stage and per-program build timings, with a text report and a JSON dump
+ */
+
+#ifndef SHADERTIMINGS_HPP
+#define SHADERTIMINGS_HPP
+
+#include <GL/glew.h>
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+// Timing of one stage compile. With parallel compile the glCompileShader call only submits the work,
+// and the status query is where the wait shows up
+struct StageTiming {
+	unsigned long long sourceHash;
+	double compileMilliseconds;
+	double statusMilliseconds;
+	int infoLogLength;
+	bool success;
+};
+
+// Timing of one program build, from the cache or from source
+struct ProgramTiming {
+	std::string vertexPath, fragmentPath;
+	std::string defines;
+	unsigned long long cacheKey;
+	bool cacheHit;
+	bool reload;
+	StageTiming vertex, fragment;
+	double cacheLoadMilliseconds;
+	double linkMilliseconds;
+	double statusMilliseconds;
+	// Wall time from the start of the build until its result was checked, including any async wait
+	double totalMilliseconds;
+	int infoLogLength;
+	bool success;
+
+	// Constructor zeroes every field
+	ProgramTiming();
+};
+
+// Every program build since startup, recorded on the render thread
+class ShaderBuildLog {
+public:
+	// Add a finished build
+	static void record(const ProgramTiming &timing);
+
+	// All builds in the order they finished
+	static const std::vector<ProgramTiming> &getRecords();
+
+	// Print every build, slowest first, with the totals
+	static void printReport();
+
+	// Write every build to a JSON file, false if the file could not be written
+	static bool writeJson(const std::string &path);
+
+	// Forget all builds
+	static void clear();
+
+private:
+	static std::vector<ProgramTiming> records;
+};
+
+#endif
@@ -0,0 +1,67 @@
+/*
+ * ShaderVariants.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Cache of shader permutations built from one vertex/fragment pair
+ */
+
+#include "ShaderVariants.hpp"
+
+// Constructor records the sources every variant is built from, nothing is compiled yet
+ShaderVariants::ShaderVariants(ProgramRegistry &registry, const char* vertexPath, const char* fragmentPath,
+	BaseShader::BuildMode mode)
+	: vertexPath(vertexPath), fragmentPath(fragmentPath), registry(registry), mode(mode) {
+}
+
+// Variant for a define set, compiled the first time it is requested and shared afterwards
+BaseShader &ShaderVariants::get(const ShaderDefines &defines) {
+	std::string key = defines.toString();
+	std::map<std::string, ProgramHandle>::iterator it = variants.find(key);
+	if (it != variants.end()) {
+		return *it->second;
+	}
+	ProgramHandle &handle = variants[key];
+	handle = registry.acquire(vertexPath.c_str(), fragmentPath.c_str(), defines, mode);
+	return *handle;
+}
+
+// Number of distinct variants built so far
+size_t ShaderVariants::size() const {
+	return variants.size();
+}
+
+// Release every variant back to the registry
+void ShaderVariants::clear() {
+	variants.clear();
+}
+
+// Build several variants up front, reading all of their sources in parallel
+void ShaderVariants::prebuild(const std::vector<ShaderDefines> &defineSets) {
+	std::vector<ShaderDefines> missing;
+	std::vector<ShaderSourceRequest> requests;
+	for (size_t i = 0; i < defineSets.size(); i++) {
+		if (variants.count(defineSets[i].toString()) != 0) {
+			continue;
+		}
+		missing.push_back(defineSets[i]);
+		ShaderSourceRequest request;
+		request.defines = defineSets[i];
+		request.path = vertexPath;
+		requests.push_back(request);
+		request.path = fragmentPath;
+		requests.push_back(request);
+	}
+
+	// Stages that fail to load are left to get(), which reports the error and marks the variant failed
+	std::vector<ShaderSource> sources;
+	bool loaded = preprocessShaderBatch(requests, sources);
+	for (size_t i = 0; i < missing.size(); i++) {
+		if (!loaded) {
+			get(missing[i]);
+			continue;
+		}
+		variants[missing[i].toString()] = registry.acquire(vertexPath.c_str(), fragmentPath.c_str(), missing[i],
+			sources[2 * i], sources[2 * i + 1], mode);
+	}
+}
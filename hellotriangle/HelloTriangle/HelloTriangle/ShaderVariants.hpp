@@ -0,0 +1,46 @@
+/*
+ * ShaderVariants.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Cache of shader permutations built from one vertex/fragment pair
+ */
+
+#ifndef SHADERVARIANTS_HPP
+#define SHADERVARIANTS_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "BaseShader.hpp"
+#include "ProgramRegistry.hpp"
+
+class ShaderVariants {
+public:
+	// Constructor records the sources every variant is built from, nothing is compiled yet
+	ShaderVariants(ProgramRegistry &registry, const char* vertexPath, const char* fragmentPath,
+		BaseShader::BuildMode mode = BaseShader::BUILD_ASYNC);
+
+	// Variant for a define set, compiled the first time it is requested and shared afterwards
+	BaseShader &get(const ShaderDefines &defines);
+
+	// Build several variants up front, reading all of their sources in parallel
+	void prebuild(const std::vector<ShaderDefines> &defineSets);
+
+	// Number of distinct variants built so far
+	size_t size() const;
+
+	// Release every variant back to the registry
+	void clear();
+
+private:
+	std::string vertexPath, fragmentPath;
+	ProgramRegistry &registry;
+	BaseShader::BuildMode mode;
+
+	// Keyed by the canonical define text, so the same set in any order maps to one program
+	std::map<std::string, ProgramHandle> variants;
+};
+
+#endif
@@ -0,0 +1,327 @@
+/*
+ * ShaderWatcher.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Watches shader source files and hot-reloads the shaders built from them
+ */
+
+#include "ShaderWatcher.hpp"
+
+#include <chrono>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+// Split a path into its directory and file name, using "." when there is no directory
+static std::string directoryOf(const std::string &path, std::string &name) {
+	size_t slash = path.find_last_of("/\\");
+	if (slash == std::string::npos) {
+		name = path;
+		return ".";
+	}
+	name = path.substr(slash + 1);
+	return path.substr(0, slash);
+}
+
+// Directory and file name joined back into one comparable path
+static std::string normalizePath(const std::string &path) {
+	std::string name;
+	std::string directory = directoryOf(path, name);
+	return directory + "/" + name;
+}
+
+// Constructor starts the background thread that waits for file changes. Given a hidden window whose context
+// shares objects with the render thread's, reloads are compiled and linked on that thread instead of by the
+// driver in the background, for when parallel compile is unavailable
+ShaderWatcher::ShaderWatcher(GLFWwindow* reloadContext)
+	: reading(NULL), running(true), reloadContext(reloadContext), inotifyFd(-1) {
+#ifdef __linux__
+	inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotifyFd == -1) {
+		std::cout << "Warning: inotify is unavailable, polling shader files instead" << std::endl;
+	}
+#endif
+	thread = std::thread(&ShaderWatcher::run, this);
+}
+
+// Destructor stops the background thread
+ShaderWatcher::~ShaderWatcher() {
+	stop();
+#ifdef __linux__
+	if (inotifyFd != -1) {
+		close(inotifyFd);
+	}
+#endif
+}
+
+// Stop the background thread and delete reloads that were never swapped in, while the context still exists
+void ShaderWatcher::stop() {
+	if (!thread.joinable()) {
+		return;
+	}
+	running = false;
+	thread.join();
+	for (size_t i = 0; i < pending.size(); i++) {
+		if (pending[i].built) {
+			BaseShader::deleteReload(pending[i].build);
+		}
+	}
+	pending.clear();
+}
+
+// Watch every source file of a shader, including its #include files
+void ShaderWatcher::watch(BaseShader* shader) {
+	std::lock_guard<std::mutex> lock(mutex);
+	shaders.push_back(shader);
+	const std::vector<std::string> &files = shader->getSourceFiles();
+	for (size_t i = 0; i < files.size(); i++) {
+		watchDirectory(files[i]);
+	}
+}
+
+// Stop reloading a shader, which must happen before the shader is deleted. Waits if the background thread is
+// reading or building its sources
+void ShaderWatcher::unwatch(BaseShader* shader) {
+	std::unique_lock<std::mutex> lock(mutex);
+	// Once it is out of the list the background thread cannot start reading it, only finish a read or build in flight
+	readFinished.wait(lock, [this, shader]() { return reading != shader; });
+	shaders.erase(std::remove(shaders.begin(), shaders.end(), shader), shaders.end());
+	for (size_t i = 0; i < pending.size(); ) {
+		if (pending[i].shader == shader) {
+			if (pending[i].built) {
+				BaseShader::deleteReload(pending[i].build);
+			}
+			pending.erase(pending.begin() + i);
+		}
+		else {
+			i++;
+		}
+	}
+}
+
+// Called once per frame on the render thread to start and finish reloads. Only reloads started on an earlier
+// frame are polled, so without parallel compile or a reload context the wait happens a frame later
+void ShaderWatcher::update() {
+	std::vector<PendingReload> reloads;
+	std::vector<BaseShader*> watched;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		// A shader still on its first build keeps its reload queued until that build is finished
+		for (size_t i = 0; i < pending.size(); ) {
+			if (pending[i].shader->isBuilding()) {
+				i++;
+				continue;
+			}
+			reloads.push_back(pending[i]);
+			pending.erase(pending.begin() + i);
+		}
+		watched = shaders;
+	}
+	std::vector<BaseShader*> swapped;
+	for (size_t i = 0; i < watched.size(); i++) {
+		if (watched[i]->pollReload()) {
+			swapped.push_back(watched[i]);
+		}
+	}
+	// Submitting is cheap, the compile itself runs in the driver while frames keep drawing
+	for (size_t i = 0; i < reloads.size(); i++) {
+		if (reloads[i].built) {
+			// Already waited on by the background thread, so the swap does not block
+			reloads[i].shader->adoptReload(reloads[i].build);
+			if (reloads[i].shader->pollReload()) {
+				swapped.push_back(reloads[i].shader);
+			}
+		}
+		else {
+			reloads[i].shader->beginReload(reloads[i].vertexCode, reloads[i].fragmentCode);
+		}
+	}
+	if (swapped.empty()) {
+		return;
+	}
+
+	// An edit may add or remove #include files, so watch what the new program was actually built from
+	std::lock_guard<std::mutex> lock(mutex);
+	for (size_t i = 0; i < swapped.size(); i++) {
+		swapped[i]->updateSourceFiles();
+		const std::vector<std::string> &files = swapped[i]->getSourceFiles();
+		for (size_t j = 0; j < files.size(); j++) {
+			watchDirectory(files[j]);
+		}
+	}
+}
+
+// Background thread body, waits for changes and reads the affected sources
+void ShaderWatcher::run() {
+	std::vector<std::pair<std::string, time_t> > modifiedTimes;
+	if (reloadContext != NULL) {
+		glfwMakeContextCurrent(reloadContext);
+	}
+
+	while (running) {
+		std::vector<std::string> changedFiles;
+
+#ifdef __linux__
+		if (inotifyFd != -1) {
+			pollfd descriptor = { inotifyFd, POLLIN, 0 };
+			if (poll(&descriptor, 1, 100) <= 0) {
+				continue;
+			}
+			// Editors often write a file in several steps, so let them settle before reading
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			alignas(inotify_event) char buffer[4096];
+			ssize_t length;
+			while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+				for (char* cursor = buffer; cursor < buffer + length; ) {
+					inotify_event* event = (inotify_event*)cursor;
+					if (event->len > 0) {
+						std::lock_guard<std::mutex> lock(mutex);
+						for (size_t i = 0; i < watchedDirectories.size(); i++) {
+							if (watchedDirectories[i].first == event->wd) {
+								changedFiles.push_back(watchedDirectories[i].second + "/" + event->name);
+							}
+						}
+					}
+					cursor += sizeof(inotify_event) + event->len;
+				}
+			}
+			queueReloads(changedFiles);
+			continue;
+		}
+#endif
+
+		// Without inotify, compare modification times a few times a second
+		std::this_thread::sleep_for(std::chrono::milliseconds(250));
+		std::vector<std::string> files;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			for (size_t i = 0; i < shaders.size(); i++) {
+				const std::vector<std::string> &sources = shaders[i]->getSourceFiles();
+				for (size_t j = 0; j < sources.size(); j++) {
+					files.push_back(normalizePath(sources[j]));
+				}
+			}
+		}
+		for (size_t i = 0; i < files.size(); i++) {
+			struct stat info;
+			if (stat(files[i].c_str(), &info) != 0) {
+				continue;
+			}
+			size_t known = 0;
+			while (known < modifiedTimes.size() && modifiedTimes[known].first != files[i]) {
+				known++;
+			}
+			if (known == modifiedTimes.size()) {
+				modifiedTimes.push_back(std::make_pair(files[i], info.st_mtime));
+			}
+			else if (modifiedTimes[known].second != info.st_mtime) {
+				modifiedTimes[known].second = info.st_mtime;
+				changedFiles.push_back(files[i]);
+			}
+		}
+		queueReloads(changedFiles);
+	}
+
+	if (reloadContext != NULL) {
+		glfwMakeContextCurrent(NULL);
+	}
+}
+
+// Helper function to read the sources of every shader using a changed file
+void ShaderWatcher::queueReloads(const std::vector<std::string> &changedFiles) {
+	if (changedFiles.empty()) {
+		return;
+	}
+	std::vector<BaseShader*> affected;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (size_t i = 0; i < shaders.size(); i++) {
+			const std::vector<std::string> &sources = shaders[i]->getSourceFiles();
+			bool changed = false;
+			for (size_t j = 0; j < sources.size() && !changed; j++) {
+				std::string source = normalizePath(sources[j]);
+				for (size_t k = 0; k < changedFiles.size() && !changed; k++) {
+					changed = changedFiles[k] == source;
+				}
+			}
+			if (changed) {
+				affected.push_back(shaders[i]);
+			}
+		}
+	}
+
+	// File reads happen here on the watcher thread, never on the render thread
+	for (size_t i = 0; i < affected.size(); i++) {
+		PendingReload reload;
+		reload.shader = affected[i];
+		{
+			// The shader may have been unwatched, and then deleted, since the list was taken
+			std::lock_guard<std::mutex> lock(mutex);
+			if (std::find(shaders.begin(), shaders.end(), reload.shader) == shaders.end()) {
+				continue;
+			}
+			reading = reload.shader;
+		}
+		bool loaded = reload.shader->loadSources(reload.vertexCode, reload.fragmentCode);
+		if (loaded) {
+			// The sources can wait several frames to be compiled, longer than the files should stay mapped
+			reload.vertexCode.copyFiles();
+			reload.fragmentCode.copyFiles();
+		}
+		reload.built = loaded && reloadContext != NULL;
+		if (reload.built) {
+			reload.build = reload.shader->buildReload(reload.vertexCode, reload.fragmentCode);
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		reading = NULL;
+		readFinished.notify_all();
+		if (!loaded) {
+			continue;
+		}
+		size_t j = 0;
+		while (j < pending.size() && pending[j].shader != reload.shader) {
+			j++;
+		}
+		if (j == pending.size()) {
+			pending.push_back(reload);
+		}
+		else {
+			// The newer sources replace the queued ones
+			if (pending[j].built) {
+				BaseShader::deleteReload(pending[j].build);
+			}
+			pending[j] = reload;
+		}
+	}
+}
+
+// Helper function to start watching the directory that holds a file
+void ShaderWatcher::watchDirectory(const std::string &path) {
+#ifdef __linux__
+	if (inotifyFd == -1) {
+		return;
+	}
+	std::string name;
+	std::string directory = directoryOf(path, name);
+	for (size_t i = 0; i < watchedDirectories.size(); i++) {
+		if (watchedDirectories[i].second == directory) {
+			return;
+		}
+	}
+	// Editors that save through a rename show up as IN_MOVED_TO rather than IN_CLOSE_WRITE
+	int wd = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+	if (wd == -1) {
+		std::cout << "Error: could not watch shader directory " << directory << std::endl;
+		return;
+	}
+	watchedDirectories.push_back(std::make_pair(wd, directory));
+#else
+	(void)path;
+#endif
+}
@@ -0,0 +1,85 @@
+/*
+ * ShaderWatcher.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Watches shader source files and hot-reloads the shaders built from them
+ */
+
+#ifndef SHADERWATCHER_HPP
+#define SHADERWATCHER_HPP
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <utility>
+
+#include "BaseShader.hpp"
+
+class ShaderWatcher {
+public:
+	// Constructor starts the background thread that waits for file changes. Given a hidden window whose context
+	// shares objects with the render thread's, reloads are compiled and linked on that thread instead of by the
+	// driver in the background, for when parallel compile is unavailable
+	ShaderWatcher(GLFWwindow* reloadContext = NULL);
+
+	// Destructor stops the background thread
+	~ShaderWatcher();
+
+	// Stop the background thread and delete reloads that were never swapped in, while the context still exists
+	void stop();
+
+	// Watch every source file of a shader, including its #include files
+	void watch(BaseShader* shader);
+
+	// Stop reloading a shader, which must happen before the shader is deleted. Waits if the background thread is
+	// reading or building its sources
+	void unwatch(BaseShader* shader);
+
+	// Called once per frame on the render thread to start and finish reloads. Only reloads started on an earlier
+	// frame are polled, so without parallel compile or a reload context the wait happens a frame later
+	void update();
+
+private:
+	// New sources read by the background thread, waiting to be compiled, or the program already built from them
+	// when there is a reload context
+	struct PendingReload {
+		BaseShader* shader;
+		ShaderSource vertexCode;
+		ShaderSource fragmentCode;
+		bool built;
+		ReloadBuild build;
+	};
+
+	std::vector<BaseShader*> shaders;
+	std::vector<PendingReload> pending;
+	std::mutex mutex;
+	// Shader whose sources the background thread is reading and building outside the lock, unwatch waits for it
+	// to finish
+	BaseShader* reading;
+	std::condition_variable readFinished;
+	std::atomic<bool> running;
+	std::thread thread;
+	GLFWwindow* reloadContext;
+
+	// inotify descriptor and the watch descriptor of each watched directory
+	int inotifyFd;
+	std::vector<std::pair<int, std::string> > watchedDirectories;
+
+	// Background thread body, waits for changes and reads the affected sources
+	void run();
+
+	// Helper function to read the sources of every shader using a changed file
+	void queueReloads(const std::vector<std::string> &changedFiles);
+
+	// Helper function to start watching the directory that holds a file
+	void watchDirectory(const std::string &path);
+};
+
+#endif
@@ -1,14 +1,35 @@
 #version 330 core
 
-out vec4 FragColor;
+#include "FragCommon.glsl"
 
-in vec3 ourColor;
-in vec2 texCoord;
+// TEXTURE_MIX fixed at 0 or 1 builds a single texture variant that skips the other fetch
+#if defined(TEXTURE_MIX) && TEXTURE_MIX == 0
+uniform sampler2D metalTexture;
 
+void main(){
+	FragColor = TINT(texture(metalTexture, texCoord));
+}
+#elif defined(TEXTURE_MIX) && TEXTURE_MIX == 1
+uniform sampler2D happyTexture;
+
+void main(){
+	FragColor = TINT(texture(happyTexture, texCoord));
+}
+#else
 uniform sampler2D metalTexture;
 uniform sampler2D happyTexture;
+#ifdef INSTANCED
+#define textureMix instanceMix
+#elif defined(DRAW_PARAMS)
+// Per-draw values read from a range of a uniform buffer ring rather than set one uniform at a time
+layout (std140) uniform DrawParams {
+	float textureMix;
+};
+#else
 uniform float textureMix;
+#endif
 
 void main(){
-	FragColor = mix(texture(metalTexture, texCoord), texture(happyTexture, texCoord), textureMix);
-}
\ No newline at end of file
+	FragColor = TINT(mix(texture(metalTexture, texCoord), texture(happyTexture, texCoord), textureMix));
+}
+#endif
\ No newline at end of file
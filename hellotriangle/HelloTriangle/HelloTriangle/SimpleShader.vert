@@ -1,5 +1,13 @@
 #version 330 core
 
+// Built as a separable stage the block has to be redeclared so it matches any fragment stage
+#ifdef SEPARABLE_STAGE
+#extension GL_ARB_separate_shader_objects : require
+out gl_PerVertex {
+	vec4 gl_Position;
+};
+#endif
+
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aColor;
 layout (location = 2) in vec2 aTexCoord;
@@ -7,8 +15,45 @@ layout (location = 2) in vec2 aTexCoord;
 out vec3 ourColor;
 out vec2 texCoord;
 
+// Per-instance attributes, advanced once per quad by glVertexAttribDivisor. Under multi-draw indirect
+// each command's base instance is its draw ID, so these become per-draw attributes
+#ifdef INSTANCED
+#ifdef WORLD_MATRIX
+// Scene graph nodes carry the top three rows of their world matrix instead, placed by a camera
+layout (location = 7) in vec4 aWorldRow0;
+layout (location = 8) in vec4 aWorldRow1;
+layout (location = 9) in vec4 aWorldRow2;
+
+layout (std140) uniform Camera {
+	mat4 viewProjection;
+};
+#else
+layout (location = 3) in vec4 aInstanceTransform;	// offset xy, scale, rotation in radians
+#endif
+layout (location = 4) in float aInstanceMix;
+layout (location = 5) in vec4 aInstanceTint;
+
+flat out float instanceMix;
+flat out vec4 instanceTint;
+#endif
+
 void main(){
+#ifdef INSTANCED
+#ifdef WORLD_MATRIX
+	// A row vector times the columns of mat3x4 dots it with each row
+	vec3 position = vec4(aPos, 1.0) * mat3x4(aWorldRow0, aWorldRow1, aWorldRow2);
+	gl_Position = viewProjection * vec4(position, 1.0);
+#else
+	float s = sin(aInstanceTransform.w);
+	float c = cos(aInstanceTransform.w);
+	vec2 position = mat2(c, s, -s, c) * (aPos.xy * aInstanceTransform.z) + aInstanceTransform.xy;
+	gl_Position = vec4(position, aPos.z, 1.0);
+#endif
+	instanceMix = aInstanceMix;
+	instanceTint = aInstanceTint;
+#else
 	gl_Position = vec4(aPos, 1.0);
+#endif
 	ourColor = aColor;
 	texCoord = aTexCoord;
 }
\ No newline at end of file
@@ -0,0 +1,194 @@
+/*
+ * SpriteBatch.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Batches textured quads by shader and texture into as few draw calls as possible
+ */
+
+#include "SpriteBatch.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+// Sprites per draw are limited so 16-bit indices can address every vertex of the draw, the base vertex
+// places it anywhere in the region
+static const int SPRITES_PER_DRAW = 65536 / 4;
+
+// Constructor creates the vertex array, a shared index buffer and a stream buffer holding spritesPerFrame sprites
+// per frame in flight. The stream buffer grows when a frame queues more
+SpriteBatch::SpriteBatch(int spritesPerFrame)
+	: vertexArray(0), indexBuffer(0), spritesPerFrame((size_t)std::max(spritesPerFrame, 1)), mode(SORT_BY_STATE) {
+	stats.sprites = 0;
+	stats.drawCalls = 0;
+	stream.reset(new StreamBuffer(this->spritesPerFrame * 4 * sizeof(SpriteVertex)));
+
+	// The same two triangles for every sprite, so draws only differ in their base vertex
+	std::vector<unsigned short> indices(SPRITES_PER_DRAW * 6);
+	for (int i = 0; i < SPRITES_PER_DRAW; i++) {
+		unsigned short first = (unsigned short)(i * 4);
+		indices[i * 6 + 0] = first + 0;
+		indices[i * 6 + 1] = first + 1;
+		indices[i * 6 + 2] = first + 3;
+		indices[i * 6 + 3] = first + 1;
+		indices[i * 6 + 4] = first + 2;
+		indices[i * 6 + 5] = first + 3;
+	}
+
+	glGenVertexArrays(1, &vertexArray);
+	glGenBuffers(1, &indexBuffer);
+	GLState::bindVertexArray(vertexArray);
+	GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned short), indices.data(), GL_STATIC_DRAW);
+	bindStream();
+}
+
+// Destructor releases the vertex array and buffers
+SpriteBatch::~SpriteBatch() {
+	GLState::deleteVertexArray(vertexArray);
+	GLState::deleteBuffer(indexBuffer);
+}
+
+// Start queueing sprites for a frame
+void SpriteBatch::begin(SortMode mode) {
+	this->mode = mode;
+	sprites.clear();
+}
+
+// Queue a sprite, its texture is bound to unit 0 when drawn
+void SpriteBatch::draw(const Sprite &sprite) {
+	sprites.push_back(sprite);
+}
+
+void SpriteBatch::draw(BaseShader* shader, unsigned int texture, float x, float y, float width, float height) {
+	Sprite sprite = { x, y, width, height, 0.0f, 0.0f, 1.0f, 1.0f, { 1.0f, 1.0f, 1.0f }, texture, shader };
+	sprites.push_back(sprite);
+}
+
+// Write every queued sprite and draw them, flushing whenever the shader or texture changes
+void SpriteBatch::end() {
+	if (sprites.empty()) {
+		return;
+	}
+
+	// Program in the high half and texture in the low half, so one sort groups both
+	order.resize(sprites.size());
+	for (size_t i = 0; i < sprites.size(); i++) {
+		order[i].first = ((unsigned long long)sprites[i].shader->ID << 32) | sprites[i].texture;
+		order[i].second = (unsigned int)i;
+	}
+	if (mode == SORT_BY_STATE) {
+		// Ties fall back to the index, so sprites sharing state keep their queued order
+		std::sort(order.begin(), order.end());
+	}
+
+	// The whole frame goes into one region, so the ring only waits on a fence once per frame
+	if (sprites.size() > spritesPerFrame) {
+		growStream(sprites.size());
+	}
+	stream->beginFrame();
+	size_t start = 0;
+	while (start < order.size()) {
+		size_t end = start + 1;
+		while (end < order.size() && order[end].first == order[start].first) {
+			end++;
+		}
+		flush(start, end);
+		start = end;
+	}
+	stream->endFrame();
+	sprites.clear();
+}
+
+// Sprites and draw calls since the last reset
+SpriteBatchStats SpriteBatch::getStats() const {
+	return stats;
+}
+
+void SpriteBatch::resetStats() {
+	stats.sprites = 0;
+	stats.drawCalls = 0;
+}
+
+// Buffer the vertices are streamed through, for its fence wait counts
+const StreamBuffer &SpriteBatch::getStream() const {
+	return *stream;
+}
+
+// Helper function to write the sorted sprites in [start, end), which share one shader and texture
+void SpriteBatch::flush(size_t start, size_t end) {
+	const Sprite &first = sprites[order[start].second];
+	first.shader->use();
+	GLState::bindTexture(0, GL_TEXTURE_2D, first.texture);
+	GLState::bindVertexArray(vertexArray);
+
+	size_t written = start;
+	while (written < end) {
+		size_t batch = std::min(end - written, (size_t)SPRITES_PER_DRAW);
+		StreamAllocation allocation = stream->allocate(batch * 4 * sizeof(SpriteVertex), sizeof(SpriteVertex));
+		if (allocation.data == NULL) {
+			return;
+		}
+
+		SpriteVertex* vertex = (SpriteVertex*)allocation.data;
+		for (size_t i = 0; i < batch; i++) {
+			const Sprite &sprite = sprites[order[written + i].second];
+			float left = sprite.x, right = sprite.x + sprite.width;
+			float bottom = sprite.y, top = sprite.y + sprite.height;
+			// Top right, bottom right, bottom left, top left, the same order as the quad in main.cpp
+			const float corners[4][4] = {
+				{ right, top, sprite.u1, sprite.v1 },
+				{ right, bottom, sprite.u1, sprite.v0 },
+				{ left, bottom, sprite.u0, sprite.v0 },
+				{ left, top, sprite.u0, sprite.v1 }
+			};
+			for (int corner = 0; corner < 4; corner++) {
+				vertex->position[0] = corners[corner][0];
+				vertex->position[1] = corners[corner][1];
+				vertex->position[2] = 0.0f;
+				vertex->color[0] = sprite.color[0];
+				vertex->color[1] = sprite.color[1];
+				vertex->color[2] = sprite.color[2];
+				vertex->texCoord[0] = corners[corner][2];
+				vertex->texCoord[1] = corners[corner][3];
+				vertex++;
+			}
+		}
+		stream->flush();
+
+		glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)(batch * 6), GL_UNSIGNED_SHORT, 0,
+			(GLint)(allocation.offset / sizeof(SpriteVertex)));
+		stats.drawCalls++;
+		stats.sprites += (unsigned int)batch;
+		written += batch;
+	}
+}
+
+// Helper function to replace the stream buffer with one whose regions hold at least count sprites
+void SpriteBatch::growStream(size_t count) {
+	while (spritesPerFrame < count) {
+		spritesPerFrame *= 2;
+	}
+	// Deleting the old buffer is deferred by the driver until the GPU has finished reading it
+	stream.reset(new StreamBuffer(spritesPerFrame * 4 * sizeof(SpriteVertex)));
+	bindStream();
+}
+
+// Helper function to point the vertex attributes at the start of the stream buffer
+void SpriteBatch::bindStream() {
+	// Attributes read from the start of the stream buffer, each draw's base vertex selects its sprites
+	GLState::bindVertexArray(vertexArray);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, stream->buffer);
+
+	// Set up position attribute
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, position));
+	glEnableVertexAttribArray(0);
+
+	// Set up color attribute
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, color));
+	glEnableVertexAttribArray(1);
+
+	// Set up texture attribute
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*)offsetof(SpriteVertex, texCoord));
+	glEnableVertexAttribArray(2);
+}
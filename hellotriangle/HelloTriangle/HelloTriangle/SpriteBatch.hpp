@@ -0,0 +1,101 @@
+/*
+ * SpriteBatch.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Batches textured quads by shader and texture into as few draw calls as possible
+ */
+
+#ifndef SPRITEBATCH_HPP
+#define SPRITEBATCH_HPP
+
+#include <GL/glew.h>
+
+#include <memory>
+#include <vector>
+#include <utility>
+#include <iostream>
+
+#include "BaseShader.hpp"
+#include "GLState.hpp"
+#include "StreamBuffer.hpp"
+
+// Vertex layout shared with the quad in main.cpp, position, color and texture coordinates
+struct SpriteVertex {
+	float position[3];
+	float color[3];
+	float texCoord[2];
+};
+
+// One queued sprite, an axis aligned rectangle in normalized device coordinates
+struct Sprite {
+	float x, y, width, height;
+	float u0, v0, u1, v1;
+	float color[3];
+	unsigned int texture;
+	BaseShader* shader;
+};
+
+// Sprites drawn and draw calls issued since the last reset
+struct SpriteBatchStats {
+	unsigned int sprites;
+	unsigned int drawCalls;
+};
+
+class SpriteBatch {
+public:
+	// Sorting by state gives the fewest draws, submission order keeps overlapping sprites layered as queued
+	enum SortMode { SORT_BY_STATE, SORT_NONE };
+
+	// Constructor creates the vertex array, a shared index buffer and a stream buffer holding spritesPerFrame sprites
+	// per frame in flight. The stream buffer grows when a frame queues more
+	SpriteBatch(int spritesPerFrame = 16384);
+
+	// Destructor releases the vertex array and buffers
+	~SpriteBatch();
+
+	// Start queueing sprites for a frame
+	void begin(SortMode mode = SORT_BY_STATE);
+
+	// Queue a sprite, its texture is bound to unit 0 when drawn
+	void draw(const Sprite &sprite);
+	void draw(BaseShader* shader, unsigned int texture, float x, float y, float width, float height);
+
+	// Write every queued sprite and draw them, flushing whenever the shader or texture changes
+	void end();
+
+	// Sprites and draw calls since the last reset
+	SpriteBatchStats getStats() const;
+	void resetStats();
+
+	// Buffer the vertices are streamed through, for its fence wait counts
+	const StreamBuffer &getStream() const;
+
+private:
+	// Vertex array and buffers are owned, so it cannot be copied
+	SpriteBatch(const SpriteBatch &);
+	SpriteBatch &operator=(const SpriteBatch &);
+
+	unsigned int vertexArray;
+	unsigned int indexBuffer;
+	std::unique_ptr<StreamBuffer> stream;
+	size_t spritesPerFrame;
+
+	SortMode mode;
+	std::vector<Sprite> sprites;
+	// Sort key of each sprite paired with its index, sorted instead of the sprites themselves
+	std::vector<std::pair<unsigned long long, unsigned int> > order;
+
+	SpriteBatchStats stats;
+
+	// Helper function to write the sorted sprites in [start, end), which share one shader and texture
+	void flush(size_t start, size_t end);
+
+	// Helper function to replace the stream buffer with one whose regions hold at least count sprites
+	void growStream(size_t count);
+
+	// Helper function to point the vertex attributes at the start of the stream buffer
+	void bindStream();
+};
+
+#endif
@@ -0,0 +1,163 @@
+/*
+ * StreamBuffer.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Persistently mapped ring of per-frame regions for streaming dynamic data without stalls
+ */
+
+#include "StreamBuffer.hpp"
+
+#include <chrono>
+
+// Round a value up to a multiple of the alignment, which need not be a power of two for vertex strides
+static size_t alignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+// Constructor creates one region of regionSize bytes per frame in flight and maps it if it can
+StreamBuffer::StreamBuffer(size_t regionSize, int regions)
+	: buffer(0), mode(UNSYNCHRONIZED), regionSize(regionSize), regionCount(regions), region(0), used(0),
+	fences(regions, (GLsync)0), mapping(NULL), mappingStart(0), frames(0), waits(0), waitMilliseconds(0.0) {
+	// The copy target is used for all buffer work so the vertex array bindings are left alone
+	glGenBuffers(1, &buffer);
+	GLState::bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+	GLsizeiptr totalSize = (GLsizeiptr)(regionSize * regions);
+	if (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage) {
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_COPY_WRITE_BUFFER, totalSize, NULL, flags);
+		mapping = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, totalSize, flags);
+		if (mapping != NULL) {
+			mode = PERSISTENT;
+			return;
+		}
+		// Immutable storage cannot be respecified, so start again with a fresh buffer
+		std::cout << "Error: could not map the stream buffer persistently, falling back to unsynchronized maps" << std::endl;
+		GLState::deleteBuffer(buffer);
+		glGenBuffers(1, &buffer);
+		GLState::bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+	}
+	glBufferData(GL_COPY_WRITE_BUFFER, totalSize, NULL, GL_STREAM_DRAW);
+}
+
+// Destructor unmaps and releases the buffer and any pending fences
+StreamBuffer::~StreamBuffer() {
+	if (mapping != NULL) {
+		GLState::bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+	}
+	for (size_t i = 0; i < fences.size(); i++) {
+		if (fences[i]) {
+			glDeleteSync(fences[i]);
+		}
+	}
+	GLState::deleteBuffer(buffer);
+}
+
+// Move to the next region, waiting on its fence only if the GPU is still reading it
+void StreamBuffer::beginFrame() {
+	flush();
+	region = (region + 1) % regionCount;
+	used = 0;
+	frames++;
+	GLsync fence = fences[region];
+	if (!fence) {
+		return;
+	}
+
+	// Poll first, so a fence that has already passed is not counted as a wait
+	GLenum result = glClientWaitSync(fence, 0, 0);
+	if (result == GL_TIMEOUT_EXPIRED) {
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		waits++;
+		do {
+			result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+		} while (result == GL_TIMEOUT_EXPIRED);
+		waitMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+	if (result == GL_WAIT_FAILED) {
+		std::cout << "Error: waiting on a stream buffer fence failed" << std::endl;
+	}
+	glDeleteSync(fence);
+	fences[region] = 0;
+}
+
+// Reserve space in this frame's region to write into, data is NULL if the region is full
+StreamAllocation StreamBuffer::allocate(size_t size, size_t alignment) {
+	StreamAllocation allocation;
+	size_t start = alignUp(used, alignment);
+	if (start + size > regionSize) {
+		std::cout << "Error: stream buffer region is full, " << regionSize << " bytes per frame" << std::endl;
+		allocation.offset = 0;
+		allocation.size = 0;
+		allocation.data = NULL;
+		return allocation;
+	}
+	size_t regionStart = regionSize * region;
+	if (mode == PERSISTENT) {
+		allocation.data = mapping + regionStart + start;
+	}
+	else {
+		// Map the rest of the region at once so a batch of allocations needs only one map and unmap
+		if (mapping == NULL) {
+			GLState::bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+			mappingStart = start;
+			mapping = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, regionStart + start, regionSize - start,
+				GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+			if (mapping == NULL) {
+				std::cout << "Error: could not map the stream buffer" << std::endl;
+				allocation.offset = 0;
+				allocation.size = 0;
+				allocation.data = NULL;
+				return allocation;
+			}
+		}
+		allocation.data = mapping + (start - mappingStart);
+	}
+	allocation.offset = regionStart + start;
+	allocation.size = size;
+	used = start + size;
+	return allocation;
+}
+
+// Make everything written so far visible to draws, a no-op for a coherent persistent mapping
+void StreamBuffer::flush() {
+	if (mode == UNSYNCHRONIZED && mapping != NULL) {
+		GLState::bindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		mapping = NULL;
+	}
+}
+
+// Fence the region after the last draw that reads it has been issued
+void StreamBuffer::endFrame() {
+	flush();
+	if (fences[region]) {
+		glDeleteSync(fences[region]);
+	}
+	fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+// Which path the buffer is using and how big each region is
+StreamBuffer::Mode StreamBuffer::getMode() const {
+	return mode;
+}
+
+size_t StreamBuffer::getRegionSize() const {
+	return regionSize;
+}
+
+// Frames where the CPU had to block on a fence, and the time spent blocked
+unsigned int StreamBuffer::getWaitCount() const {
+	return waits;
+}
+
+double StreamBuffer::getWaitMilliseconds() const {
+	return waitMilliseconds;
+}
+
+// Print how often the CPU waited on the GPU
+void StreamBuffer::printReport() const {
+	std::cout << "Stream buffer (" << (mode == PERSISTENT ? "persistent" : "unsynchronized") << "): "
+		<< frames << " frames, " << waits << " fence waits, " << waitMilliseconds << " ms waited" << std::endl;
+}
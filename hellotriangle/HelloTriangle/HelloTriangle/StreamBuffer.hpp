@@ -0,0 +1,83 @@
+/*
+ * StreamBuffer.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Persistently mapped ring of per-frame regions for streaming dynamic data without stalls
+ */
+
+#ifndef STREAMBUFFER_HPP
+#define STREAMBUFFER_HPP
+
+#include <GL/glew.h>
+
+#include <vector>
+#include <iostream>
+
+#include "GLState.hpp"
+
+// Space handed out from the current region, offset is from the start of the whole buffer
+struct StreamAllocation {
+	size_t offset;
+	size_t size;
+	unsigned char* data;
+};
+
+class StreamBuffer {
+public:
+	// Persistent needs GL 4.4 or GL_ARB_buffer_storage, older contexts map each batch unsynchronized
+	enum Mode { PERSISTENT, UNSYNCHRONIZED };
+
+	unsigned int buffer;
+
+	// Constructor creates one region of regionSize bytes per frame in flight and maps it if it can
+	StreamBuffer(size_t regionSize, int regions = 3);
+
+	// Destructor unmaps and releases the buffer and any pending fences
+	~StreamBuffer();
+
+	// Move to the next region, waiting on its fence only if the GPU is still reading it
+	void beginFrame();
+
+	// Reserve space in this frame's region to write into, data is NULL if the region is full
+	StreamAllocation allocate(size_t size, size_t alignment = 16);
+
+	// Make everything written so far visible to draws, a no-op for a coherent persistent mapping
+	void flush();
+
+	// Fence the region after the last draw that reads it has been issued
+	void endFrame();
+
+	// Which path the buffer is using and how big each region is
+	Mode getMode() const;
+	size_t getRegionSize() const;
+
+	// Frames where the CPU had to block on a fence, and the time spent blocked
+	unsigned int getWaitCount() const;
+	double getWaitMilliseconds() const;
+
+	// Print how often the CPU waited on the GPU
+	void printReport() const;
+
+private:
+	// The mapping and fences are owned, so it cannot be copied
+	StreamBuffer(const StreamBuffer &);
+	StreamBuffer &operator=(const StreamBuffer &);
+
+	Mode mode;
+	size_t regionSize;
+	int regionCount;
+	int region;
+	size_t used;
+	std::vector<GLsync> fences;
+
+	// Whole buffer for a persistent mapping, the current batch for the unsynchronized path
+	unsigned char* mapping;
+	size_t mappingStart;
+
+	unsigned int frames;
+	unsigned int waits;
+	double waitMilliseconds;
+};
+
+#endif
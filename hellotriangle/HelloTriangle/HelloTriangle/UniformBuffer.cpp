@@ -0,0 +1,215 @@
+/*
+ * UniformBuffer.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * std140/std430 block layout builder and a per-frame uniform buffer ring
+ */
+
+#include "UniformBuffer.hpp"
+
+#include <cstring>
+
+// Round a value up to a multiple of a power of two alignment
+static size_t alignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Number of components in one column of a GLSL type, and the number of columns
+static void typeShape(GLenum type, int &rows, int &columns) {
+	columns = 1;
+	switch (type) {
+	case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_BOOL_VEC2: rows = 2; break;
+	case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_BOOL_VEC3: rows = 3; break;
+	case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_BOOL_VEC4: rows = 4; break;
+	case GL_FLOAT_MAT2: rows = 2; columns = 2; break;
+	case GL_FLOAT_MAT3: rows = 3; columns = 3; break;
+	case GL_FLOAT_MAT4: rows = 4; columns = 4; break;
+	default: rows = 1; break;
+	}
+}
+
+// Constructor starts an empty block using the given packing rule
+BlockLayout::BlockLayout(Rule rule) : rule(rule), offset(0), maxAlignment(rule == STD140 ? 16 : 4) {
+}
+
+// Place the next member, type is a GLSL type enum such as GL_FLOAT_VEC4, returns its offset
+size_t BlockLayout::add(const std::string &name, GLenum type, int arrayCount) {
+	int rows, columns;
+	typeShape(type, rows, columns);
+
+	// A vector aligns to two or four components, vec3 rounding up to four
+	size_t vectorAlignment = rows == 1 ? 4 : (rows == 2 ? 8 : 16);
+	size_t vectorSize = rows * 4;
+
+	BlockMember member;
+	member.name = name;
+	member.type = type;
+	member.arrayCount = arrayCount;
+	member.matrixStride = 0;
+
+	size_t alignment, elementSize;
+	if (columns > 1) {
+		// Matrices are laid out as an array of column vectors
+		size_t columnAlignment = rule == STD140 ? 16 : vectorAlignment;
+		member.matrixStride = alignUp(vectorSize, columnAlignment);
+		alignment = columnAlignment;
+		elementSize = member.matrixStride * columns;
+	}
+	else {
+		alignment = vectorAlignment;
+		elementSize = vectorSize;
+	}
+	// std140 rounds the alignment and stride of every array element up to a vec4
+	if (arrayCount > 1 && rule == STD140) {
+		alignment = alignUp(alignment, 16);
+	}
+	member.arrayStride = alignUp(elementSize, alignment);
+
+	member.offset = alignUp(offset, alignment);
+	offset = member.offset + (arrayCount > 1 ? member.arrayStride * arrayCount : elementSize);
+	if (alignment > maxAlignment) {
+		maxAlignment = alignment;
+	}
+	members.push_back(member);
+	return member.offset;
+}
+
+// Look up a placed member, NULL if there is none with the name
+const BlockMember* BlockLayout::find(const std::string &name) const {
+	for (size_t i = 0; i < members.size(); i++) {
+		if (members[i].name == name) {
+			return &members[i];
+		}
+	}
+	return NULL;
+}
+
+// Size of the whole block including its trailing padding
+size_t BlockLayout::size() const {
+	return alignUp(offset, maxAlignment);
+}
+
+// Copy one tightly packed element into the block, spreading matrix columns out to the member's stride
+void BlockLayout::write(unsigned char* block, const BlockMember &member, const void* value, int element) const {
+	int rows, columns;
+	typeShape(member.type, rows, columns);
+	unsigned char* destination = block + member.offset + member.arrayStride * element;
+	const unsigned char* source = (const unsigned char*)value;
+	if (columns == 1) {
+		std::memcpy(destination, source, rows * 4);
+		return;
+	}
+	for (int c = 0; c < columns; c++) {
+		std::memcpy(destination + member.matrixStride * c, source + rows * 4 * c, rows * 4);
+	}
+}
+
+// Compare the offsets with the ones the driver reports for a block in a shader, printing mismatches
+bool BlockLayout::validate(const BaseShader &shader, const std::string &blockName) const {
+	const UniformBlockInfo* block = shader.getUniformBlock(blockName);
+	if (block == NULL) {
+		std::cout << "Error: uniform block " << blockName << " is not active" << std::endl;
+		return false;
+	}
+	bool matches = true;
+	for (size_t i = 0; i < block->members.size(); i++) {
+		const UniformBlockMember &driverMember = block->members[i];
+		// Members may be reported as "Block.member" or "member[0]"
+		std::string name = driverMember.name;
+		size_t dot = name.find_last_of('.');
+		if (dot != std::string::npos) {
+			name = name.substr(dot + 1);
+		}
+		if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+			name.resize(name.size() - 3);
+		}
+		const BlockMember* member = find(name);
+		if (member == NULL || member->offset != (size_t)driverMember.offset) {
+			std::cout << "Error: block " << blockName << " member " << name << " is at offset " << driverMember.offset
+				<< " in the shader but " << (member ? (long)member->offset : -1L) << " in the layout" << std::endl;
+			matches = false;
+		}
+	}
+	if ((size_t)block->dataSize > size()) {
+		std::cout << "Error: block " << blockName << " needs " << block->dataSize << " bytes but the layout has " << size() << std::endl;
+		matches = false;
+	}
+	return matches;
+}
+
+// Constructor creates a buffer with one region of frameCapacity bytes for each frame in flight
+UniformRing::UniformRing(size_t frameCapacity, int framesInFlight)
+	: frameCapacity(frameCapacity), framesInFlight(framesInFlight), frame(0), used(0), flushed(0),
+	fences(framesInFlight, (GLsync)0) {
+	int offsetAlignment = 256;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+	alignment = (size_t)offsetAlignment;
+	// Regions start on a bindable offset too
+	this->frameCapacity = alignUp(frameCapacity, alignment);
+	staging.resize(this->frameCapacity);
+
+	glGenBuffers(1, &buffer);
+	GLState::bindBuffer(GL_UNIFORM_BUFFER, buffer);
+	glBufferData(GL_UNIFORM_BUFFER, this->frameCapacity * framesInFlight, NULL, GL_DYNAMIC_DRAW);
+}
+
+// Destructor releases the buffer and any pending fences
+UniformRing::~UniformRing() {
+	for (size_t i = 0; i < fences.size(); i++) {
+		if (fences[i]) {
+			glDeleteSync(fences[i]);
+		}
+	}
+	GLState::deleteBuffer(buffer);
+}
+
+// Move to the next region, waiting only if the GPU is still reading it from framesInFlight frames ago
+void UniformRing::beginFrame() {
+	frame = (frame + 1) % framesInFlight;
+	if (fences[frame]) {
+		glClientWaitSync(fences[frame], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+		glDeleteSync(fences[frame]);
+		fences[frame] = 0;
+	}
+	used = 0;
+	flushed = 0;
+}
+
+// Reserve space for one block in this frame's region, data is NULL if the region is full
+UniformAllocation UniformRing::allocate(size_t size) {
+	UniformAllocation allocation;
+	size_t start = alignUp(used, alignment);
+	if (start + size > frameCapacity) {
+		std::cout << "Error: uniform ring is full, " << frameCapacity << " bytes per frame" << std::endl;
+		allocation.offset = 0;
+		allocation.size = 0;
+		allocation.data = NULL;
+		return allocation;
+	}
+	allocation.offset = frameCapacity * frame + start;
+	allocation.size = size;
+	allocation.data = staging.data() + start;
+	used = start + size;
+	return allocation;
+}
+
+// Upload everything allocated this frame with a single glBufferSubData
+void UniformRing::flush() {
+	if (used == flushed) {
+		return;
+	}
+	GLState::bindBuffer(GL_UNIFORM_BUFFER, buffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, frameCapacity * frame + flushed, used - flushed, staging.data() + flushed);
+	flushed = used;
+}
+
+// Bind an allocation to a uniform buffer binding point with glBindBufferRange
+void UniformRing::bind(unsigned int binding, const UniformAllocation &allocation) const {
+	GLState::bindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, allocation.offset, allocation.size);
+}
+
+// Fence the region so it is not overwritten while draws still read it
+void UniformRing::endFrame() {
+	fences[frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
@@ -0,0 +1,103 @@
+/*
+ * UniformBuffer.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * std140/std430 block layout builder and a per-frame uniform buffer ring
+ */
+
+#ifndef UNIFORMBUFFER_HPP
+#define UNIFORMBUFFER_HPP
+
+#include <GL/glew.h>
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "BaseShader.hpp"
+
+// Member placed by a BlockLayout
+struct BlockMember {
+	std::string name;
+	GLenum type;
+	int arrayCount;
+	size_t offset;
+	size_t arrayStride;
+	size_t matrixStride;
+};
+
+class BlockLayout {
+public:
+	// std140 is required for uniform blocks, std430 is only allowed for shader storage blocks
+	enum Rule { STD140, STD430 };
+
+	// Constructor starts an empty block using the given packing rule
+	BlockLayout(Rule rule = STD140);
+
+	// Place the next member, type is a GLSL type enum such as GL_FLOAT_VEC4, returns its offset
+	size_t add(const std::string &name, GLenum type, int arrayCount = 1);
+
+	// Look up a placed member, NULL if there is none with the name
+	const BlockMember* find(const std::string &name) const;
+
+	// Size of the whole block including its trailing padding
+	size_t size() const;
+
+	// Copy one tightly packed element into the block, spreading matrix columns out to the member's stride
+	void write(unsigned char* block, const BlockMember &member, const void* value, int element = 0) const;
+
+	// Compare the offsets with the ones the driver reports for a block in a shader, printing mismatches
+	bool validate(const BaseShader &shader, const std::string &blockName) const;
+
+private:
+	Rule rule;
+	size_t offset;
+	size_t maxAlignment;
+	std::vector<BlockMember> members;
+};
+
+// Region of the ring handed out for one draw's parameters
+struct UniformAllocation {
+	size_t offset;
+	size_t size;
+	unsigned char* data;
+};
+
+class UniformRing {
+public:
+	// Constructor creates a buffer with one region of frameCapacity bytes for each frame in flight
+	UniformRing(size_t frameCapacity, int framesInFlight = 3);
+
+	// Destructor releases the buffer and any pending fences
+	~UniformRing();
+
+	// Move to the next region, waiting only if the GPU is still reading it from framesInFlight frames ago
+	void beginFrame();
+
+	// Reserve space for one block in this frame's region, data is NULL if the region is full
+	UniformAllocation allocate(size_t size);
+
+	// Upload everything allocated this frame with a single glBufferSubData
+	void flush();
+
+	// Bind an allocation to a uniform buffer binding point with glBindBufferRange
+	void bind(unsigned int binding, const UniformAllocation &allocation) const;
+
+	// Fence the region so it is not overwritten while draws still read it
+	void endFrame();
+
+	unsigned int buffer;
+
+private:
+	size_t frameCapacity;
+	int framesInFlight;
+	int frame;
+	size_t used;
+	size_t flushed;
+	size_t alignment;
+	std::vector<unsigned char> staging;
+	std::vector<GLsync> fences;
+};
+
+#endif
@@ -0,0 +1,75 @@
+/*
+ * UniformHandle.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Compile-time hashed uniform names and typed uniform handles
+ */
+
+#ifndef UNIFORMHANDLE_HPP
+#define UNIFORMHANDLE_HPP
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <type_traits>
+
+// FNV-1a hash of a string, usable in constant expressions
+constexpr unsigned int hashString(const char* str, size_t length) {
+	unsigned int hash = 2166136261u;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= (unsigned char)str[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static_assert(hashString("a", 1) == 0xe40c292cu, "hashString must be evaluated at compile time");
+
+// Uniform name and its hash, made with UNIFORM_NAME so the hash is computed by the compiler
+struct UniformName {
+	const char* name;
+	size_t length;
+	unsigned int hash;
+
+	constexpr UniformName(const char* name, size_t length, unsigned int hash) : name(name), length(length), hash(hash) {}
+};
+
+// Name a uniform with a string literal. The hash goes through a template argument, which has to be a constant
+// expression, so it can never fall back to being computed at run time
+#define UNIFORM_NAME(str) UniformName(str, sizeof(str) - 1, \
+	std::integral_constant<unsigned int, hashString(str, sizeof(str) - 1)>::value)
+
+static_assert(UNIFORM_NAME("a").hash == 0xe40c292cu, "UNIFORM_NAME must hash at compile time");
+
+// Uniform resolved once against a shader's uniform table, set later with no lookup
+template <typename T>
+struct UniformHandle {
+	int slot;
+
+	UniformHandle() : slot(-1) {}
+	explicit UniformHandle(int slot) : slot(slot) {}
+
+	// True if the uniform was found in the program with a matching type
+	bool valid() const { return slot != -1; }
+};
+
+// GLSL types a handle of each C++ type may be resolved against
+template <typename T> struct UniformTraits;
+
+template <> struct UniformTraits<float> {
+	static bool matches(GLenum type) { return type == GL_FLOAT; }
+};
+
+template <> struct UniformTraits<int> {
+	static bool matches(GLenum type) {
+		return type == GL_INT || type == GL_SAMPLER_1D || type == GL_SAMPLER_2D || type == GL_SAMPLER_3D
+			|| type == GL_SAMPLER_CUBE || type == GL_SAMPLER_2D_ARRAY;
+	}
+};
+
+template <> struct UniformTraits<bool> {
+	static bool matches(GLenum type) { return type == GL_BOOL || type == GL_INT; }
+};
+
+#endif
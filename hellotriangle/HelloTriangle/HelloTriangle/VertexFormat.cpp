@@ -0,0 +1,209 @@
+/*
+ * VertexFormat.cpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Vertex layout descriptors with quantized attribute storage and automatic vertex array setup
+ */
+
+#include "VertexFormat.hpp"
+
+#include <cmath>
+#include <cstring>
+
+// Bytes taken by one component of a storage type, 10_10_10_2 packs all four into one 4 byte word
+static size_t storageBytes(VertexFormat::Storage storage, int components) {
+	switch (storage) {
+	case VertexFormat::FLOAT32:          return 4 * components;
+	case VertexFormat::HALF:             return 2 * components;
+	case VertexFormat::UNORM16:          return 2 * components;
+	case VertexFormat::UNORM8:           return components;
+	case VertexFormat::SNORM_10_10_10_2: return 4;
+	}
+	return 0;
+}
+
+// Round a value up to a multiple of a power of two alignment
+static size_t alignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Clamp a value into a range, counting the values that did not fit
+static float clampCounted(float value, float low, float high, size_t &clamped) {
+	if (value < low || value > high || value != value) {
+		clamped++;
+		return value > high ? high : low;
+	}
+	return value;
+}
+
+// Constructor starts an empty layout
+VertexFormat::VertexFormat() : size(0) {
+}
+
+// Append an attribute, SNORM_10_10_10_2 always stores 4 components in 4 bytes
+VertexFormat &VertexFormat::add(unsigned int location, int components, Storage storage) {
+	Attribute attribute;
+	attribute.location = location;
+	attribute.components = storage == SNORM_10_10_10_2 ? 4 : components;
+	attribute.storage = storage;
+	attribute.offset = size;
+	attributes.push_back(attribute);
+	size = alignUp(size + storageBytes(storage, attribute.components), 4);
+	return *this;
+}
+
+// Bytes per vertex, every attribute starts on a 4 byte boundary
+size_t VertexFormat::stride() const {
+	return size;
+}
+
+// Attributes in the order they were added
+const std::vector<VertexFormat::Attribute> &VertexFormat::getAttributes() const {
+	return attributes;
+}
+
+// Point the vertex array's attributes at buffer, starting at offset bytes
+void VertexFormat::apply(unsigned int vertexArray, unsigned int buffer, size_t offset) const {
+	GLState::bindVertexArray(vertexArray);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, buffer);
+	for (size_t i = 0; i < attributes.size(); i++) {
+		const Attribute &attribute = attributes[i];
+		const char* pointer = (const char*)(offset + attribute.offset);
+		switch (attribute.storage) {
+		case FLOAT32:
+			glVertexAttribPointer(attribute.location, attribute.components, GL_FLOAT, GL_FALSE, (GLsizei)size, pointer);
+			break;
+		case HALF:
+			glVertexAttribPointer(attribute.location, attribute.components, GL_HALF_FLOAT, GL_FALSE, (GLsizei)size, pointer);
+			break;
+		case UNORM16:
+			glVertexAttribPointer(attribute.location, attribute.components, GL_UNSIGNED_SHORT, GL_TRUE, (GLsizei)size, pointer);
+			break;
+		case UNORM8:
+			glVertexAttribPointer(attribute.location, attribute.components, GL_UNSIGNED_BYTE, GL_TRUE, (GLsizei)size, pointer);
+			break;
+		case SNORM_10_10_10_2:
+			glVertexAttribPointer(attribute.location, 4, GL_INT_2_10_10_10_REV, GL_TRUE, (GLsizei)size, pointer);
+			break;
+		}
+		glEnableVertexAttribArray(attribute.location);
+	}
+}
+
+// Quantize float streams into interleaved vertices, sources[i] holds the components of attribute i for every vertex,
+// returns the number of values that had to be clamped
+size_t VertexFormat::pack(const std::vector<const float*> &sources, size_t vertexCount, std::vector<unsigned char> &output) const {
+	size_t clamped = 0;
+	output.assign(vertexCount * size, 0);
+	for (size_t i = 0; i < attributes.size() && i < sources.size(); i++) {
+		const Attribute &attribute = attributes[i];
+		// 10_10_10_2 attributes take xyz from a 3 component source and leave w at zero
+		int sourceComponents = attribute.storage == SNORM_10_10_10_2 ? 3 : attribute.components;
+		for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+			const float* source = sources[i] + vertex * sourceComponents;
+			unsigned char* destination = output.data() + vertex * size + attribute.offset;
+			switch (attribute.storage) {
+			case FLOAT32:
+				std::memcpy(destination, source, 4 * attribute.components);
+				break;
+			case HALF:
+				for (int c = 0; c < attribute.components; c++) {
+					unsigned short half = floatToHalf(source[c]);
+					std::memcpy(destination + 2 * c, &half, 2);
+				}
+				break;
+			case UNORM16:
+				for (int c = 0; c < attribute.components; c++) {
+					unsigned short value = (unsigned short)std::floor(clampCounted(source[c], 0.0f, 1.0f, clamped) * 65535.0f + 0.5f);
+					std::memcpy(destination + 2 * c, &value, 2);
+				}
+				break;
+			case UNORM8:
+				for (int c = 0; c < attribute.components; c++) {
+					destination[c] = (unsigned char)std::floor(clampCounted(source[c], 0.0f, 1.0f, clamped) * 255.0f + 0.5f);
+				}
+				break;
+			case SNORM_10_10_10_2: {
+				// x in the low bits, then y, then z, with the 2-bit w left at zero
+				unsigned int packed = 0;
+				for (int c = 0; c < 3; c++) {
+					int value = (int)std::floor(clampCounted(source[c], -1.0f, 1.0f, clamped) * 511.0f + 0.5f);
+					packed |= ((unsigned int)value & 0x3FFu) << (10 * c);
+				}
+				std::memcpy(destination, &packed, 4);
+				break;
+			}
+			}
+		}
+	}
+	return clamped;
+}
+
+// Convert between 32-bit floats and 16-bit halves, rounding to nearest even
+unsigned short VertexFormat::floatToHalf(float value) {
+	unsigned int bits;
+	std::memcpy(&bits, &value, 4);
+	unsigned int sign = (bits >> 16) & 0x8000u;
+	unsigned int exponent = (bits >> 23) & 0xFFu;
+	unsigned int mantissa = bits & 0x7FFFFFu;
+
+	// Infinity and NaN keep their class, NaN keeps a mantissa bit so it does not become infinity
+	if (exponent == 0xFFu) {
+		return (unsigned short)(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+	}
+	int halfExponent = (int)exponent - 127 + 15;
+	if (halfExponent >= 31) {
+		return (unsigned short)(sign | 0x7C00u);
+	}
+	if (halfExponent <= 0) {
+		// Subnormal half, or zero once the value is too small
+		if (halfExponent < -10) {
+			return (unsigned short)sign;
+		}
+		mantissa |= 0x800000u;
+		unsigned int shift = (unsigned int)(14 - halfExponent);
+		unsigned int half = mantissa >> shift;
+		unsigned int remainder = mantissa & ((1u << shift) - 1);
+		unsigned int halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+			half++;
+		}
+		return (unsigned short)(sign | half);
+	}
+	unsigned int half = ((unsigned int)halfExponent << 10) | (mantissa >> 13);
+	unsigned int remainder = mantissa & 0x1FFFu;
+	// A carry out of the mantissa correctly moves up to the next exponent, or to infinity
+	if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+		half++;
+	}
+	return (unsigned short)(sign | half);
+}
+
+float VertexFormat::halfToFloat(unsigned short half) {
+	unsigned int sign = (unsigned int)(half & 0x8000u) << 16;
+	unsigned int exponent = (half >> 10) & 0x1Fu;
+	unsigned int mantissa = half & 0x3FFu;
+	unsigned int bits;
+	if (exponent == 0x1Fu) {
+		bits = sign | 0x7F800000u | (mantissa << 13);
+	}
+	else if (exponent != 0) {
+		bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+	}
+	else if (mantissa == 0) {
+		bits = sign;
+	}
+	else {
+		// Normalize a subnormal half
+		int shift = 0;
+		while ((mantissa & 0x400u) == 0) {
+			mantissa <<= 1;
+			shift++;
+		}
+		bits = sign | ((unsigned int)(127 - 15 + 1 - shift) << 23) | ((mantissa & 0x3FFu) << 13);
+	}
+	float value;
+	std::memcpy(&value, &bits, 4);
+	return value;
+}
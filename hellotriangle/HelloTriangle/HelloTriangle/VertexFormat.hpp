@@ -0,0 +1,61 @@
+/*
+ * VertexFormat.hpp
+ * Chris Schultz
+ * 18 October 2026
+ *
+ * Vertex layout descriptors with quantized attribute storage and automatic vertex array setup
+ */
+
+#ifndef VERTEXFORMAT_HPP
+#define VERTEXFORMAT_HPP
+
+#include <GL/glew.h>
+
+#include <vector>
+#include <iostream>
+
+#include "GLState.hpp"
+
+class VertexFormat {
+public:
+	// Storage for one attribute. Normalized formats expect UNORM data in [0, 1] and SNORM data in [-1, 1],
+	// anything outside is clamped and counted
+	enum Storage { FLOAT32, HALF, UNORM16, UNORM8, SNORM_10_10_10_2 };
+
+	// Attribute placed in the vertex
+	struct Attribute {
+		unsigned int location;
+		int components;
+		Storage storage;
+		size_t offset;
+	};
+
+	// Constructor starts an empty layout
+	VertexFormat();
+
+	// Append an attribute, SNORM_10_10_10_2 always stores 4 components in 4 bytes
+	VertexFormat &add(unsigned int location, int components, Storage storage);
+
+	// Bytes per vertex, every attribute starts on a 4 byte boundary
+	size_t stride() const;
+
+	// Attributes in the order they were added
+	const std::vector<Attribute> &getAttributes() const;
+
+	// Point the vertex array's attributes at buffer, starting at offset bytes
+	void apply(unsigned int vertexArray, unsigned int buffer, size_t offset = 0) const;
+
+	// Quantize float streams into interleaved vertices, sources[i] holds the components of attribute i for every vertex,
+	// returns the number of values that had to be clamped
+	size_t pack(const std::vector<const float*> &sources, size_t vertexCount, std::vector<unsigned char> &output) const;
+
+	// Convert between 32-bit floats and 16-bit halves, rounding to nearest even
+	static unsigned short floatToHalf(float value);
+	static float halfToFloat(unsigned short half);
+
+private:
+	std::vector<Attribute> attributes;
+	size_t size;
+};
+
+#endif
@@ -10,10 +10,24 @@
 #include "stb_image.h"
 
 #include <iostream>
+#include <memory>
+#include <cmath>
+#include <algorithm>
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include "BaseShader.hpp"
+#include "Benchmark.hpp"
+#include "ShaderWatcher.hpp"
+#include "ShaderVariants.hpp"
+#include "ProgramRegistry.hpp"
+#include "ShaderPipeline.hpp"
+#include "IndirectDraw.hpp"
+#include "IndexBuffer.hpp"
+#include "FrustumCulling.hpp"
+#include "RenderQueue.hpp"
+#include "JobSystem.hpp"
+#include "UniformBuffer.hpp"
 
 /*
  * FUNCTION PROTOTYPES
@@ -29,14 +43,18 @@ void processInput(GLFWwindow* window, float &mixValue);
  * TEMPORARY GLOBAL VARIABLES
  */
 
+// Uniform buffer binding point of the quad's per-draw parameters
+const unsigned int DRAW_PARAMS_BINDING = 1;
+
 /*
  * MAIN BODY
  */
 
-int main() {
+int main(int argc, char* argv[]) {
 	GLFWwindow * window;
 	GLenum err;
 	float mixValue = 0.2f;
+	bool benchmarkMode = argc > 1 && std::string(argv[1]) == "--benchmark";
 
 	/* ----- Create the GLFW Window ----- */
 
@@ -46,6 +64,9 @@ int main() {
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	if (benchmarkMode) {
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	}
 
 	// Create the window object
 	window = glfwCreateWindow(800, 600, "Hello Triangle", NULL, NULL);
@@ -70,7 +91,70 @@ int main() {
 
 	/* ----- Build and compile the shader program ----- */
 	 
-	BaseShader ShaderOne("SimpleShader.vert", "SimpleShader.frag");
+	ProgramBinaryCache shaderCache("shader_cache");
+
+	// Edits to the shader files are recompiled in the background and swapped in between frames. Without parallel
+	// compile the driver cannot report progress without blocking, so the watcher builds reloads itself in a
+	// hidden context that shares objects with this one
+	GLFWwindow* reloadContext = NULL;
+	if (!BaseShader::enableParallelCompile()) {
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		reloadContext = glfwCreateWindow(1, 1, "Shader reload", NULL, window);
+	}
+	ShaderWatcher shaderWatcher(reloadContext);
+
+	// Worker threads for decoding, culling and command building, this thread is worker 0
+	JobSystem jobs;
+
+	// Every program is built through the registry, so identical requests share one GL program
+	ProgramRegistry programs(&shaderCache, &shaderWatcher);
+
+	// The fallback draws a flat color while the textured programs compile in the background. With separate
+	// shader objects it is drawn from single stages, so other fragment stages can share the vertex stage
+	PipelineCache pipelines;
+	std::unique_ptr<ShaderStage> simpleVertex, flatFragment;
+	ProgramHandle FallbackShader;
+	if (ShaderStage::isSupported()) {
+		simpleVertex.reset(new ShaderStage(GL_VERTEX_SHADER, "SimpleShader.vert", ShaderDefines(), &shaderCache));
+		flatFragment.reset(new ShaderStage(GL_FRAGMENT_SHADER, "FragTwo.frag", ShaderDefines(), &shaderCache));
+		if (!pipelines.bind(*simpleVertex, *flatFragment)) {
+			pipelines.clear();
+			simpleVertex.reset();
+			flatFragment.reset();
+		}
+	}
+	if (!simpleVertex) {
+		FallbackShader = programs.acquire("SimpleShader.vert", "FragTwo.frag");
+		if (FallbackShader->hasFailed()) {
+			std::cout << "Error: failed to build the fallback shader" << std::endl;
+			FallbackShader.release();
+			shaderWatcher.stop();
+			glfwTerminate();
+			return -1;
+		}
+	}
+
+	// The full texture mix, plus single texture variants for when the mix sits at either end and an instanced
+	// full mix for the demo scene. The scene graph benchmark adds one placed by world matrices
+	ShaderVariants texturedShaders(programs, "SimpleShader.vert", "SimpleShader.frag");
+	std::vector<ShaderDefines> texturedDefines(benchmarkMode ? 5 : 4);
+	texturedDefines[1].set("TEXTURE_MIX", 0);
+	texturedDefines[2].set("TEXTURE_MIX", 1);
+	texturedDefines[3].set("INSTANCED");
+	if (benchmarkMode) {
+		texturedDefines[4].set("INSTANCED").set("WORLD_MATRIX");
+	}
+	// Outside the benchmarks, which measure plain uniform calls, the full mix reads its mix from a uniform block
+	if (!benchmarkMode) {
+		texturedDefines[0].set("DRAW_PARAMS");
+	}
+	texturedShaders.prebuild(texturedDefines);
+	BaseShader* texturedVariants[3] = {
+		&texturedShaders.get(texturedDefines[0]),
+		&texturedShaders.get(texturedDefines[1]),
+		&texturedShaders.get(texturedDefines[2])
+	};
+	BaseShader &sceneShader = texturedShaders.get(texturedDefines[3]);
 
 	/* ----- Set up vertex data and configure attributes ----- */
 
@@ -90,17 +174,18 @@ int main() {
 	};
 
 	// Declare and generate buffer objects
-	unsigned int vao, vbo, ebo;
+	unsigned int vao, vbo;
 	glGenVertexArrays(1, &vao);
 	glGenBuffers(1, &vbo);
-	glGenBuffers(1, &ebo);
 
 	// Set up the objects for the first triangle
-	glBindVertexArray(vao);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	GLState::bindVertexArray(vao);
+	GLState::bindBuffer(GL_ARRAY_BUFFER, vbo);
 	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	// Four vertices only need byte indices
+	std::unique_ptr<IndexBuffer> quadIndices(new IndexBuffer());
+	quadIndices->upload(vao, std::vector<unsigned int>(indices, indices + 6), 4);
 
 	// Set up position attribute
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
@@ -119,9 +204,18 @@ int main() {
 	unsigned int texture, texture2;
 	stbi_set_flip_vertically_on_load(true);
 
+	// Both images are decoded on the job system while the texture objects are set up, GL calls stay on this thread
+	const char* imagePaths[2] = { "metal.jpg", "happy.png" };
+	unsigned char* imageData[2] = { NULL, NULL };
+	int imageWidths[2], imageHeights[2], imageChannels[2];
+	JobCounter imagesDecoded;
+	jobs.parallelFor(2, 1, [&](size_t image, size_t) {
+		imageData[image] = stbi_load(imagePaths[image], &imageWidths[image], &imageHeights[image], &imageChannels[image], 0);
+	}, &imagesDecoded);
+
 	// Generate, bind, and load first texture
 	glGenTextures(1, &texture);
-	glBindTexture(GL_TEXTURE_2D, texture);
+	GLState::bindTexture(0, GL_TEXTURE_2D, texture);
 
 	// Set the texture parameters
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_LINEAR);
@@ -129,9 +223,10 @@ int main() {
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 
-	// Load the image usisng the stb_image functions
-	int width, height, numChannels;
-	unsigned char *data = stbi_load("metal.jpg", &width, &height, &numChannels, 0);
+	// Wait for the images, running one of the decodes here if no worker has taken it yet
+	jobs.wait(imagesDecoded);
+	int width = imageWidths[0], height = imageHeights[0];
+	unsigned char *data = imageData[0];
 
 	if (data) {
 		// @params Texture target, mipmap level, texture storage format, width, height, always 0,
@@ -146,7 +241,7 @@ int main() {
 
 	// Generate, bind, and load second texture
 	glGenTextures(1, &texture2);
-	glBindTexture(GL_TEXTURE_2D, texture2);
+	GLState::bindTexture(0, GL_TEXTURE_2D, texture2);
 
 	// Set the texture parameters
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_MIRRORED_REPEAT);
@@ -155,7 +250,9 @@ int main() {
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 
 	// Load the image
-	data = stbi_load("happy.png", &width, &height, &numChannels, 0);
+	data = imageData[1];
+	width = imageWidths[1];
+	height = imageHeights[1];
 	if (data) {
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
 		glGenerateMipmap(GL_TEXTURE_2D);
@@ -165,42 +262,306 @@ int main() {
 	}
 	stbi_image_free(data);
 
-	ShaderOne.use();
+	/* ----- Set up the demo scene ----- */
+
+	// A grid of quads and triangles, both meshes drawn from the quad's buffers by one indirect call
+	const int sceneSide = 64;
+	std::unique_ptr<InstancedQuads> sceneQuads;
+	std::unique_ptr<IndirectDrawBuilder> sceneCommands;
+	std::vector<QuadInstance> sceneInstances(sceneSide * sceneSide);
+	if (IndirectDrawBuilder::isSupported()) {
+		sceneQuads.reset(new InstancedQuads(vbo, *quadIndices, sceneInstances.size()));
+		sceneCommands.reset(new IndirectDrawBuilder(sceneInstances.size()));
+	}
+
+	// Each object is bounded by the circle through the quad's corners, culled against clip space every frame
+	const float identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+	const Frustum sceneFrustum = Frustum::fromMatrix(identity);
+	FrustumCuller sceneCuller;
+	for (int i = 0; i < sceneSide * sceneSide; i++) {
+		sceneCuller.addSphere(i, 0.0f, 0.0f, 0.0f, 0.0f);
+	}
+	const size_t sceneBatch = 512;
+	std::vector<std::vector<unsigned int> > sceneVisible((sceneInstances.size() + sceneBatch - 1) / sceneBatch);
+	std::vector<QuadInstance> sceneDrawn;
+	bool sceneReady = false;
+
+	// Draws outside the demo scene go through a queue sorted to keep state switches down
+	RenderQueue renderQueue;
 
-	ShaderOne.setInt("metalTexture", 0);
-	ShaderOne.setInt("happyTexture", 1);
+	// Per-draw values of the quad are written to a slice of a ring each frame and bound by range
+	BlockLayout drawParams;
+	drawParams.add("textureMix", GL_FLOAT);
+	const BlockMember &textureMixMember = *drawParams.find("textureMix");
+	std::unique_ptr<UniformRing> drawRing(new UniformRing(drawParams.size()));
+
+	bool variantReady[3] = { false, false, false };
+	unsigned long long uniformsIssued = 0, uniformsSkipped = 0;
+	unsigned long long stateIssued = 0, stateElided = 0;
 
 	// Tell OpenGL the size of the rendering window
-	glViewport(0, 0, 800, 600);
+	GLState::viewport(0, 0, 800, 600);
+
+	/* ----- Run the microbenchmarks instead of the render loop ----- */
+	if (benchmarkMode) {
+		texturedVariants[0]->finishBuild();
+		benchmarkUniformUpdates(*texturedVariants[0], 5000, 100);
+
+		// Instanced quads use the full mix variant with per-instance mix and tint attributes
+		sceneShader.finishBuild();
+		if (!sceneShader.hasFailed()) {
+			sceneShader.use();
+			sceneShader.setInt("metalTexture", 0);
+			sceneShader.setInt("happyTexture", 1);
+			GLState::bindTexture(0, GL_TEXTURE_2D, texture);
+			GLState::bindTexture(1, GL_TEXTURE_2D, texture2);
+			InstancedQuads quads(vbo, *quadIndices, 1000000);
+			benchmarkInstancedQuads(sceneShader, quads, 1000000, 60);
+		}
+
+		// Sprites alternate between the two single texture variants, each reading its texture from unit 0
+		for (int i = 1; i < 3; i++) {
+			texturedVariants[i]->finishBuild();
+			texturedVariants[i]->use();
+			texturedVariants[i]->setInt(i == 1 ? "metalTexture" : "happyTexture", 0);
+		}
+		if (!texturedVariants[1]->hasFailed() && !texturedVariants[2]->hasFailed()) {
+			BaseShader* spriteShaders[2] = { texturedVariants[1], texturedVariants[2] };
+			unsigned int spriteTextures[2] = { texture, texture2 };
+			SpriteBatch sprites;
+			benchmarkSpriteBatch(sprites, spriteShaders, spriteTextures, 20);
+		}
+
+		// The metal-only variant keeps the fragment work small so vertex fetch dominates
+		if (!texturedVariants[1]->hasFailed()) {
+			GLState::bindTexture(0, GL_TEXTURE_2D, texture);
+			benchmarkVertexFormats(*texturedVariants[1], 1024, 60);
+			benchmarkIndexWidths(*texturedVariants[1], 1024, 60);
+		}
+
+		// An OBJ file can follow --benchmark, otherwise a generated sphere is loaded
+		if (!texturedVariants[1]->hasFailed()) {
+			benchmarkObjLoader(*texturedVariants[1], argc > 2 ? argv[2] : "", 60);
+		}
+
+		// Spheres are placed by the instanced variant's transform, given as constant attributes
+		if (!sceneShader.hasFailed()) {
+			GLState::bindTexture(0, GL_TEXTURE_2D, texture);
+			GLState::bindTexture(1, GL_TEXTURE_2D, texture2);
+			benchmarkMeshLod(sceneShader, 600.0f, 120);
+		}
+
+		benchmarkFrustumCulling(1000000, 20);
+
+		// Scene graph nodes use the world matrix variant, reading the same two textures
+		BaseShader &graphShader = texturedShaders.get(texturedDefines[4]);
+		graphShader.finishBuild();
+		if (!graphShader.hasFailed()) {
+			graphShader.use();
+			graphShader.setInt("metalTexture", 0);
+			graphShader.setInt("happyTexture", 1);
+			benchmarkSceneGraph(graphShader, 100000, 120);
+		}
+
+		// The full mix reads both units, the single texture variants read unit 0 as set up for the sprites
+		if (!texturedVariants[0]->hasFailed() && !texturedVariants[1]->hasFailed() && !texturedVariants[2]->hasFailed()) {
+			texturedVariants[0]->use();
+			texturedVariants[0]->setInt("metalTexture", 0);
+			texturedVariants[0]->setInt("happyTexture", 1);
+			texturedVariants[0]->setFloat("textureMix", 0.5f);
+			unsigned int queueTextures[2] = { texture, texture2 };
+			benchmarkRenderQueue(texturedVariants, queueTextures, 10000, 60);
+		}
+
+		benchmarkJobSystem(std::max(1u, std::thread::hardware_concurrency()), 1000000, 30);
+
+		shaderCache.printReport();
+		programs.printReport();
+		pipelines.printReport();
+		ShaderBuildLog::printReport();
+		ShaderBuildLog::writeJson("shader_timings.json");
+		texturedShaders.clear();
+		FallbackShader.release();
+		pipelines.clear();
+		simpleVertex.reset();
+		flatFragment.reset();
+		sceneQuads.reset();
+		sceneCommands.reset();
+		quadIndices.reset();
+		drawRing.reset();
+		shaderWatcher.stop();
+		glfwTerminate();
+		return 0;
+	}
 
 	/* ----- Render loop ----- */
 	while (!glfwWindowShouldClose(window)) {
 
 		// Test for user input
 		processInput(window, mixValue);
+		BaseShader::resetFrameStats();
+		GLState::resetFrameStats();
+
+		// Swap in any shaders that finished reloading at the frame boundary
+		shaderWatcher.update();
+
+		// Pick the cheapest variant for the current mix, set up each one once its async build has finished
+		int variant = mixValue <= 0.0f ? 1 : (mixValue >= 1.0f ? 2 : 0);
+		for (int i = 0; i < 3; i++) {
+			if (!variantReady[i] && (i == variant || i == 0) && texturedVariants[i]->isReady()) {
+				texturedVariants[i]->use();
+				texturedVariants[i]->setInt("metalTexture", 0);
+				texturedVariants[i]->setInt("happyTexture", 1);
+				if (i == 0) {
+					drawParams.validate(*texturedVariants[0], "DrawParams");
+					texturedVariants[0]->bindUniformBlock("DrawParams", DRAW_PARAMS_BINDING);
+				}
+				variantReady[i] = true;
+			}
+		}
+		// The full mix can stand in for a single texture variant that is still compiling
+		if (!variantReady[variant]) {
+			variant = 0;
+		}
+		if (!sceneReady && sceneQuads && sceneShader.isReady()) {
+			sceneShader.use();
+			sceneShader.setInt("metalTexture", 0);
+			sceneShader.setInt("happyTexture", 1);
+			sceneReady = true;
+		}
 
 		// Execute rendering commands
 		glClearColor(0.255f, 0.588f, 0.882f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
 
-		// Bind the textures to the appropriate units
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, texture);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, texture2);
+		// Bind the textures to the appropriate units, after the first frame these are all elided
+		GLState::bindTexture(0, GL_TEXTURE_2D, texture);
+		GLState::bindTexture(1, GL_TEXTURE_2D, texture2);
+
+		// Draw the demo scene, every visible object in one call with its transform, mix and tint read by draw ID
+		if (sceneReady) {
+			float time = (float)glfwGetTime();
+			float cell = 2.0f / sceneSide;
+			// The grid sways sideways so up to half of it leaves the window and is culled
+			float sway = std::sin(time * 0.5f);
+
+			// Each batch of objects is placed and culled as one job
+			JobCounter culled;
+			jobs.parallelFor(sceneInstances.size(), sceneBatch, [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; i++) {
+					QuadInstance &object = sceneInstances[i];
+					int column = (int)i % sceneSide, row = (int)i / sceneSide;
+					object.x = -1.0f + cell * (column + 0.5f) + sway;
+					object.y = -1.0f + cell * (row + 0.5f);
+					object.scale = cell;
+					sceneCuller.setSphere(i, object.x, object.y, 0.0f, cell * 0.7072f);
+					object.rotation = time + 0.05f * (column + row);
+					object.textureMix = mixValue;
+					object.tint[0] = 0.5f + 0.5f * column / sceneSide;
+					object.tint[1] = 0.5f + 0.5f * row / sceneSide;
+					object.tint[2] = 1.0f;
+					object.tint[3] = 1.0f;
+				}
+				std::vector<unsigned int> &visible = sceneVisible[begin / sceneBatch];
+				visible.clear();
+				sceneCuller.cull(sceneFrustum, visible, begin, end);
+			}, &culled);
+
+			// Once every batch is culled its offset in the compacted list is known, so the visible instances are
+			// gathered and their commands recorded in parallel too
+			JobCounter gathered;
+			sceneDrawn.resize(sceneInstances.size());
+			sceneCommands->resize(sceneInstances.size());
+			jobs.parallelFor(sceneVisible.size(), 1, [&](size_t batch, size_t) {
+				size_t offset = 0;
+				for (size_t i = 0; i < batch; i++) {
+					offset += sceneVisible[i].size();
+				}
+				for (size_t i = 0; i < sceneVisible[batch].size(); i++) {
+					unsigned int object = sceneVisible[batch][i];
+					sceneDrawn[offset + i] = sceneInstances[object];
+					// Every other object uses only the first triangle of the quad as a second mesh
+					sceneCommands->set((unsigned int)(offset + i), object % 2 == 0 ? 6 : 3, 0);
+				}
+			}, &gathered, &culled);
+			jobs.wait(gathered);
+
+			// Only the visible objects are streamed and drawn, the GL thread just uploads them
+			size_t visibleCount = 0;
+			for (size_t batch = 0; batch < sceneVisible.size(); batch++) {
+				visibleCount += sceneVisible[batch].size();
+			}
+			sceneDrawn.resize(visibleCount);
+			sceneCommands->resize(visibleCount);
+			if (!sceneDrawn.empty()) {
+				sceneShader.use();
+				sceneQuads->upload(sceneDrawn);
+				sceneQuads->draw(*sceneCommands);
+			}
+		}
 
-		ShaderOne.setFloat("textureMix", mixValue);
+		// Draw the single quad over the scene every frame. The full mix reads this frame's slice of the ring instead
+		// of a uniform set on its program
+		bool paramsBound = variant == 0 && variantReady[0];
+		if (paramsBound) {
+			drawRing->beginFrame();
+			UniformAllocation params = drawRing->allocate(drawParams.size());
+			drawParams.write(params.data, textureMixMember, &mixValue);
+			drawRing->flush();
+			drawRing->bind(DRAW_PARAMS_BINDING, params);
+		}
+		if (variantReady[variant]) {
+			RenderItem quad = { texturedVariants[variant]->ID, { texture, texture2 }, vao, GL_TRIANGLES, 6,
+				quadIndices->getType(), 0, 0, 1, 0, false, 0.5f };
+			renderQueue.clear();
+			renderQueue.add(quad);
+			renderQueue.submit();
+		}
+		else {
+			if (simpleVertex) {
+				pipelines.bind(*simpleVertex, *flatFragment);
+			}
+			else {
+				FallbackShader->use();
+			}
+			quadIndices->draw();
+		}
+		if (paramsBound) {
+			drawRing->endFrame();
+		}
 
-		// Draw the first triangle
-		ShaderOne.use();
-		glBindVertexArray(vao);
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		// Keep a running total of the uniform calls made and avoided
+		uniformsIssued += BaseShader::getFrameStats().issued;
+		uniformsSkipped += BaseShader::getFrameStats().skipped;
+		stateIssued += GLState::getFrameStats().issued;
+		stateElided += GLState::getFrameStats().elided;
 
 		// Check and call events and swap the buffers
 		glfwSwapBuffers(window);
 		glfwPollEvents();
 	}
 
+	shaderCache.printReport();
+	std::cout << "Uniform calls: " << uniformsIssued << " issued, " << uniformsSkipped << " skipped" << std::endl;
+	std::cout << "GL state calls: " << stateIssued << " issued, " << stateElided << " elided" << std::endl;
+	renderQueue.printReport("main");
+	programs.printReport();
+	pipelines.printReport();
+	ShaderBuildLog::printReport();
+	ShaderBuildLog::writeJson("shader_timings.json");
+
+	// Programs have to be deleted while the context still exists
+	texturedShaders.clear();
+	FallbackShader.release();
+	pipelines.clear();
+	simpleVertex.reset();
+	flatFragment.reset();
+	sceneQuads.reset();
+	sceneCommands.reset();
+	quadIndices.reset();
+	drawRing.reset();
+	shaderWatcher.stop();
+
 	// Terminate the window, cleaning all of GLFW's allocated resources
 	glfwTerminate();
 	return 0;
@@ -212,7 +573,7 @@ int main() {
 
 // Callback function that gets called each time the window is resized */
 void frameBufferSizeCallback(GLFWwindow* window, int width, int height) {
-	glViewport(0, 0, width, height);
+	GLState::viewport(0, 0, width, height);
 	glfwSetFramebufferSizeCallback(window, frameBufferSizeCallback);
 }
 